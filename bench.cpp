@@ -0,0 +1,276 @@
+/******************************************************************************\
+*  bench.cpp                                                                   *
+*                                                                              *
+*  A headless search benchmark. Each position is searched to a fixed depth     *
+*  with one thread and then with several, from an empty table both times, and  *
+*  the time to reach that depth is compared. With -compare the nodes needed    *
+*  for that depth are counted instead, with each pruning technique alone,      *
+*  none and all of them, and all of them with full window searches.            *
+*                                                                              *
+*      bench [OPTIONS]                                                         *
+*                                                                              *
+*      -depth D      The depth to search to, 12 by default or 7 to compare.    *
+*      -hash MB      Size of the transposition table.                          *
+*      -threads N    Threads for the second run, every core by default.        *
+*      -pruning MASK The SEARCH_* techniques to use, all by default.           *
+*      -compare      Compare the pruning techniques on one thread.             *
+*      -log          Print every finished iteration of the main thread.        *
+*      -lines N      Search for the N best root moves, each with its line.     *
+*                                                                              *
+*              Written by Abed Na'ran                          October 2026    *
+*                                                                              *
+\******************************************************************************/
+#include "config.h"
+#include "attacks.h"
+#include "search.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <unistd.h>
+
+/* The default transposition table size in megabytes.                         */
+#define BENCH_HASH_MB (64)
+
+/* The default depths to search to, searching without pruning is far slower.  */
+#define BENCH_DEPTH (12)
+#define BENCH_COMPARE_DEPTH (7)
+
+typedef struct BenchCase {
+    const char *Name;
+    const char *FEN;
+} BenchCase;
+
+/* Openings, middlegames and an endgame, quiet and tactical.                  */
+static const BenchCase BenchCases[] = {
+    {"start", "rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1"},
+    {"kiwipete",
+     "r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 1"},
+    {"italian",
+     "r1bqk2r/pppp1ppp/2n2n2/2b1p3/2B1P3/2NP1N2/PPP2PPP/R1BQK2R b KQkq - 0 5"},
+    {"middlegame",
+     "r4rk1/1pp1qppp/p1np1n2/2b1p1B1/2B1P1b1/P1NP1N2/1PP1QPPP/R4RK1 w - - 0 10"},
+    {"endgame", "8/2p5/3p4/KP5r/1R3p1k/8/4P1P1/8 w - - 0 1"},
+};
+
+/* The pruning settings -compare runs, by column.                             */
+static const struct {
+    const char *Name;
+    int Pruning;
+} BenchPruning[] = {
+    {"none", 0},
+    {"null", SEARCH_NULL_MOVE},
+    {"lmr", SEARCH_LMR},
+    {"futility", SEARCH_FUTILITY},
+    {"reverse", SEARCH_REVERSE_FUTILITY},
+    {"pvs", SEARCH_PVS},
+    {"aspiration", SEARCH_ASPIRATION},
+    {"full window", SEARCH_PRUNE_ALL & ~(SEARCH_PVS | SEARCH_ASPIRATION)},
+    {"all", SEARCH_PRUNE_ALL},
+};
+
+#define BENCH_CASES (sizeof(BenchCases) / sizeof(*BenchCases))
+#define BENCH_PRUNING (sizeof(BenchPruning) / sizeof(*BenchPruning))
+
+static ChessPosition Position;
+
+/* A context is some 75KB, a full set of them can't live on the stack.        */
+static SearchContext Contexts[SEARCH_MAX_THREADS];
+static TTable Table;
+
+static void Log(const SearchResult *Result);
+static void Run(int Threads, int Depth, int Pruning, SearchResult *Result);
+static double Branching(const SearchResult *Result);
+static void Speedup(int Depth, int Threads, int Pruning);
+static void Compare(int Depth);
+
+/* The iteration, then each of its lines when there is more than one.         */
+void Log(const SearchResult *Result)
+{
+    char Move[CHESS_MOVE_TEXT];
+
+    printf("  depth %2d score %6d %12llu nodes %8.3fs\n",
+           Result -> Depth,
+           Result -> Score,
+           Result -> Nodes,
+           Result -> Seconds);
+
+    for (int i = 0; Result -> LineCount > 1 && i < Result -> LineCount; i++) {
+        printf("    %d depth %2d %6d",
+               i + 1,
+               Result -> Lines[i].Depth,
+               Result -> Lines[i].Score);
+        for (int j = 0; j < Result -> Lines[i].PVLength; j++) {
+            MoveWrite(Result -> Lines[i].PV[j], Move);
+            printf(" %s", Move);
+        }
+
+        printf("\n");
+    }
+}
+
+/* Search Position from an empty table.                                       */
+void Run(int Threads, int Depth, int Pruning, SearchResult *Result)
+{
+    SearchLimits Limits = {Depth, 0, 0, NULL};
+
+    TTClear(&Table);
+    Contexts[0].Table = &Table;
+    Contexts[0].Pruning = Pruning;
+    SearchParallel(Contexts, Threads, &Position, &Limits, Result);
+}
+
+/* The effective branching factor, the average number of children that        */
+/* would give the same node count over the same depth.                        */
+double Branching(const SearchResult *Result)
+{
+    if (!Result -> Depth)
+        return 0;
+
+    return pow((double)Result -> Nodes, 1.0 / Result -> Depth);
+}
+
+void Speedup(int Depth, int Threads, int Pruning)
+{
+    double Single = 0, Parallel = 0;
+
+    printf("depth %d, %zuMB hash%s, 1 thread against %d\n",
+           Depth,
+           Table.Bytes >> 20,
+           Table.HugePages ? " on huge pages" : "",
+           Threads);
+
+    for (size_t i = 0; i < BENCH_CASES; i++) {
+        SearchResult One, Many;
+
+        if (!PositionFromFEN(&Position, BenchCases[i].FEN)) {
+            printf("%-12s bad FEN\n", BenchCases[i].Name);
+            continue;
+        }
+
+        Run(1, Depth, Pruning, &One);
+        Run(Threads, Depth, Pruning, &Many);
+        Single += One.Seconds;
+        Parallel += Many.Seconds;
+
+        printf("%-12s %8.3fs %6.2f Mnps  %8.3fs %6.2f Mnps  %5.2fx  "
+               "%3.0f%% hits %4d/1000 full %3.0f%% first move cuts\n",
+               BenchCases[i].Name,
+               One.Seconds,
+               SearchNPS(&One) / 1e6,
+               Many.Seconds,
+               SearchNPS(&Many) / 1e6,
+               Many.Seconds > 0 ? One.Seconds / Many.Seconds : 0.0,
+               SearchHitRate(&Many) * 100,
+               Many.Fill,
+               SearchCutoffRate(&Many) * 100);
+    }
+
+    printf("total        %8.3fs               %8.3fs               %5.2fx\n",
+           Single,
+           Parallel,
+           Parallel > 0 ? Single / Parallel : 0.0);
+}
+
+/* One row of node counts per position, then the totals and the branching     */
+/* factor the totals give.                                                    */
+void Compare(int Depth)
+{
+    unsigned long long Totals[BENCH_PRUNING] = {0};
+    SearchResult Result;
+
+    printf("depth %d, nodes by pruning\n%-12s", Depth, "");
+    for (size_t j = 0; j < BENCH_PRUNING; j++)
+        printf(" %11s", BenchPruning[j].Name);
+
+    printf("\n");
+    for (size_t i = 0; i < BENCH_CASES; i++) {
+        if (!PositionFromFEN(&Position, BenchCases[i].FEN)) {
+            printf("%-12s bad FEN\n", BenchCases[i].Name);
+            continue;
+        }
+
+        printf("%-12s", BenchCases[i].Name);
+        for (size_t j = 0; j < BENCH_PRUNING; j++) {
+            Run(1, Depth, BenchPruning[j].Pruning, &Result);
+            Totals[j] += Result.Nodes;
+            printf(" %11llu", Result.Nodes);
+            fflush(stdout);
+        }
+
+        printf("\n");
+    }
+
+    printf("%-12s", "total");
+    for (size_t j = 0; j < BENCH_PRUNING; j++)
+        printf(" %11llu", Totals[j]);
+
+    printf("\n%-12s", "branching");
+    for (size_t j = 0; j < BENCH_PRUNING; j++) {
+        Result.Nodes = Totals[j] / BENCH_CASES;
+        Result.Depth = Depth;
+        printf(" %11.2f", Branching(&Result));
+    }
+
+    printf("\n");
+}
+
+int main(int argc, const char *argv[])
+{
+    size_t Megabytes = BENCH_HASH_MB;
+    int Depth = 0, Threads, Pruning = SEARCH_PRUNE_ALL;
+    EMBERS_BOOL Comparing = EMBERS_FALSE;
+
+    Threads = (int)sysconf(_SC_NPROCESSORS_ONLN);
+
+    for (int Arg = 1; Arg < argc; Arg++) {
+        if (!strcmp(argv[Arg], "-depth") && Arg + 1 < argc) {
+            Depth = atoi(argv[++Arg]);
+        } else if (!strcmp(argv[Arg], "-hash") && Arg + 1 < argc) {
+            Megabytes = strtoul(argv[++Arg], NULL, 10);
+        } else if (!strcmp(argv[Arg], "-threads") && Arg + 1 < argc) {
+            Threads = atoi(argv[++Arg]);
+        } else if (!strcmp(argv[Arg], "-pruning") && Arg + 1 < argc) {
+            Pruning = (int)strtol(argv[++Arg], NULL, 0);
+        } else if (!strcmp(argv[Arg], "-compare")) {
+            Comparing = EMBERS_TRUE;
+        } else if (!strcmp(argv[Arg], "-log")) {
+            Contexts[0].Report = Log;
+        } else if (!strcmp(argv[Arg], "-lines") && Arg + 1 < argc) {
+            Contexts[0].MultiPV = atoi(argv[++Arg]);
+        } else {
+            fprintf(stderr,
+                    "usage: %s [-depth D] [-hash MB] [-threads N] "
+                    "[-pruning MASK] [-compare] [-log] [-lines N]\n",
+                    argv[0]);
+            return EXIT_FAILURE;
+        }
+    }
+
+    if (!Depth)
+        Depth = Comparing ? BENCH_COMPARE_DEPTH : BENCH_DEPTH;
+
+    if (Depth < 1 || Depth >= SEARCH_MAX_PLY) {
+        fprintf(stderr, "bad depth: %d\n", Depth);
+        return EXIT_FAILURE;
+    }
+
+    if (Threads < 1)
+        Threads = 1;
+    else if (Threads > SEARCH_MAX_THREADS)
+        Threads = SEARCH_MAX_THREADS;
+
+    AttacksInit();
+    if (!TTCreate(&Table, Megabytes)) {
+        fprintf(stderr, "can't allocate a %zuMB table\n", Megabytes);
+        return EXIT_FAILURE;
+    }
+
+    if (Comparing)
+        Compare(Depth);
+    else
+        Speedup(Depth, Threads, Pruning);
+
+    TTFree(&Table);
+    return EXIT_SUCCESS;
+}
@@ -6,6 +6,8 @@
 #include "chess.h"
 #include "stdlib.h"
 #include "image.h"
+#include "attacks.h"
+#include <string.h>
 
 #define BOARD_WIDTH (8)
 #define BOARD_HEIGHT (8)
@@ -18,6 +20,12 @@
 #define CHESS_TEXTURE_PIECES (0)
 #define CHESS_TEXTURE_DATA (1)
 
+/* Green for a highlighted square. Candidates fade down from the top one by   */
+/* rank, staying under the highlight and above an empty square.               */
+#define CHESS_GREEN_HIGHLIGHT (0xff)
+#define CHESS_GREEN_CANDIDATE (0xc0)
+#define CHESS_GREEN_RANK_STEP (0x18)
+
 enum Corners {
     CORNER_TOP_LEFT = 0,
     CORNER_TOP_RIGHT,
@@ -27,7 +35,14 @@ enum Corners {
 
 enum TextureType {
     TEXTURE_THREE_CHANNELS,
-    TEXTURE_ONE_CHANNEL
+    TEXTURE_TWO_CHANNELS
+};
+
+/* The channels of the data texture.                                          */
+enum {
+    CHESS_DATA_PIECE = 0,
+    CHESS_DATA_HIGHLIGHT,
+    CHESS_DATA_CHANNELS
 };
 
 typedef struct GridCell {
@@ -38,8 +53,12 @@ typedef struct GridCell {
 
 static struct Game {
     GridCell *Inner; /* The inner board mesh.                                 */
-    unsigned char FlagsTexture[64]; /* Describes the game state.              */
-    unsigned char Trash; /* Used as a reference when given illegal values.    */
+    ChessPosition Position; /* The game state, the source of truth.           */
+    Bitboard Highlight; /* Highlighted squares, UI state only.                */
+    unsigned char Candidates[BOARD_SIZE]; /* Rank plus one, 0 for none.       */
+
+    /* Derived from Position, Highlight and Candidates on upload.             */
+    unsigned char DataTexture[BOARD_SIZE][CHESS_DATA_CHANNELS];
     GLuint Textures[2]; /* 0 for pieces, 1 for data.                          */
 
     /* Opengl buffers.                                                        */
@@ -49,6 +68,7 @@ static struct Game {
 } *Game;
 
 static inline void PopulateBoard();
+static inline void DeriveData();
 static inline void PrepBoardBuffers();
 static inline void PrepareTexture(int Tex,
                                   void *Data,
@@ -84,10 +104,25 @@ void PopulateBoard()
         return;
     }
 
-    for (int i = 0; i < 8; i++)
-        for (int j = 0; j < 8; j++)
-            Board(i, j) = ImageGetPixel(Positions, i, j).r;
+    PositionClear(&Game -> Position);
+    Game -> Highlight = BITBOARD_EMPTY;
+    memset(Game -> Candidates, 0, sizeof(Game -> Candidates));
+    for (int i = 0; i < 8; i++) {
+        for (int j = 0; j < 8; j++) {
+            unsigned char Flags = ImageGetPixel(Positions, i, j).r;
+
+            if (!(Flags & (CHESS_FLAG_WHITE | CHESS_FLAG_BLACK)))
+                continue;
+
+            PositionSetPiece(&Game -> Position,
+                             ChessCellSquare(i, j),
+                             CHESS_PIECE(Flags & CHESS_FLAG_WHITE ?
+                                         CHESS_WHITE : CHESS_BLACK,
+                                         Flags >> 4));
+        }
+    }
 
+    PositionInferCastling(&Game -> Position);
     ImageFree(Positions);
 
     /* Calculate the mesh.                                                    */
@@ -148,6 +183,7 @@ void PrepBoardBuffers()
                            Game -> Inner,
                            GL_STATIC_DRAW));
 
+    DeriveData();
     EMBERS_GL(glGenTextures(2, Game -> Textures));
     PrepareTexture(Game -> Textures[CHESS_TEXTURE_PIECES],
                    Pieces -> Pixels,
@@ -155,10 +191,10 @@ void PrepBoardBuffers()
                    Pieces -> Height);
 
     PrepareTexture(Game -> Textures[CHESS_TEXTURE_DATA],
-                   Game -> FlagsTexture,
+                   Game -> DataTexture,
                    BOARD_WIDTH,
                    BOARD_HEIGHT,
-                   TEXTURE_ONE_CHANNEL);
+                   TEXTURE_TWO_CHANNELS);
 
     Game -> Program = EmbersCreateProgram();
     EmbersShader VertexShader = EmbersLoadShader("./shaders/vert.glsl", GL_VERTEX_SHADER),
@@ -181,6 +217,14 @@ void PrepBoardBuffers()
 
 void ChessInit()
 {
+    AttacksInit();
+#ifdef EMBERS_DEBUG
+    if (!AttacksSelfCheck()) {
+        EMBERS_ERROR(EMBERS_BAD_TABLES);
+        return;
+    }
+#endif
+
     PopulateBoard();
     PrepBoardBuffers();
 
@@ -258,16 +302,77 @@ void ChessDraw()
     glDrawArrays(GL_TRIANGLES, 0, BOARD_SIZE * 6);
 }
 
-unsigned char &Board(int x, int y)
+unsigned char Board(int x, int y)
 {
+    int Piece;
+
     if (x < 0 || y < 0 || x >= 8 || y >= 8)
-        return Game -> Trash;
+        return 0;
+
+    Piece = Game -> Position.Squares[ChessCellSquare(x, y)];
+    if (Piece == CHESS_NO_PIECE)
+        return 0;
+
+    return (CHESS_PIECE_TYPE(Piece) << 4) |
+           (CHESS_PIECE_COLOUR(Piece) == CHESS_WHITE ? CHESS_FLAG_WHITE :
+                                                       CHESS_FLAG_BLACK);
+}
+
+void ChessSetHighlight(Bitboard Squares)
+{
+    Game -> Highlight = Squares;
+    memset(Game -> Candidates, 0, sizeof(Game -> Candidates));
+}
+
+void ChessSetCandidates(const ChessMove *Moves, int Count)
+{
+    unsigned char *Rank;
+
+    Game -> Highlight = BITBOARD_EMPTY;
+    memset(Game -> Candidates, 0, sizeof(Game -> Candidates));
+
+    /* Promotions share a destination, the better ranked one keeps it.        */
+    for (int i = 0; i < Count && i < CHESS_MAX_CANDIDATES; i++) {
+        if (Moves[i] == CHESS_NO_MOVE)
+            continue;
+
+        Rank = &Game -> Candidates[MoveTo(Moves[i])];
+        if (!*Rank)
+            *Rank = i + 1;
+    }
+}
 
-    return Game -> FlagsTexture[x + y * BOARD_WIDTH];
+ChessPosition *ChessGetPosition()
+{
+    return &Game -> Position;
+}
+
+/* Rebuild the texture, the pieces in the red channel and the highlight or    */
+/* the candidate's rank in the green one.                                     */
+void DeriveData()
+{
+    for (int y = 0; y < BOARD_HEIGHT; y++) {
+        for (int x = 0; x < BOARD_WIDTH; x++) {
+            unsigned char *Cell = Game -> DataTexture[x + y * BOARD_WIDTH];
+            int Square = ChessCellSquare(x, y),
+                Rank = Game -> Candidates[Square];
+
+            Cell[CHESS_DATA_PIECE] = Board(x, y);
+            if (Game -> Highlight & BITBOARD_SQUARE(Square))
+                Cell[CHESS_DATA_HIGHLIGHT] = CHESS_GREEN_HIGHLIGHT;
+            else if (Rank)
+                Cell[CHESS_DATA_HIGHLIGHT] = CHESS_GREEN_CANDIDATE -
+                                             CHESS_GREEN_RANK_STEP * (Rank - 1);
+            else
+                Cell[CHESS_DATA_HIGHLIGHT] = 0;
+        }
+    }
 }
 
 void ChessUploadBoard()
 {
+    DeriveData();
+
     /* Just change the data on the GPU.                                       */
     EMBERS_GL(glBindTexture(GL_TEXTURE_2D, Game -> Textures[CHESS_TEXTURE_DATA]));
     EMBERS_GL(glTexSubImage2D(GL_TEXTURE_2D,
@@ -276,9 +381,9 @@ void ChessUploadBoard()
                               0,
                               BOARD_WIDTH,
                               BOARD_HEIGHT,
-                              GL_RED,
+                              GL_RG,
                               GL_UNSIGNED_BYTE,
-                              Game -> FlagsTexture));
+                              Game -> DataTexture));
 
 }
 
@@ -306,11 +411,11 @@ void PrepareTexture(int Tex,
     EMBERS_GL(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST));
     EMBERS_GL(glTexImage2D(GL_TEXTURE_2D,
                            0,
-                           Type == TEXTURE_THREE_CHANNELS ? GL_RGB : GL_R8,
+                           Type == TEXTURE_THREE_CHANNELS ? GL_RGB : GL_RG8,
                            Width,
                            Height,
                            0,
-                           Type == TEXTURE_THREE_CHANNELS ? GL_RGB : GL_RED,
+                           Type == TEXTURE_THREE_CHANNELS ? GL_RGB : GL_RG,
                            GL_UNSIGNED_BYTE,
                            Data));
 
@@ -9,9 +9,13 @@
 #ifndef CHESS_H
 #define CHESS_H
 #include "config.h"
+#include "position.h"
 
+/* The most candidate moves ChessSetCandidates tells apart by rank.           */
+#define CHESS_MAX_CANDIDATES (8)
+
+/* Highlighting is kept apart from the pieces, see ChessSetHighlight.         */
 enum {
-    CHESS_FLAG_HIGHLITED = 0x01,
     CHESS_FLAG_WHITE = 0x02,
     CHESS_FLAG_BLACK = 0x04,
     CHESS_FLAG_KING = 0x00,
@@ -22,6 +26,44 @@ enum {
     CHESS_FLAG_PAWN = 0x50,
 };
 
+/* Cells are stored from black's back rank down with the files running from   */
+/* h to a, so a cell maps to its square by flipping the index.                */
+constexpr int ChessCellSquare(int x, int y)
+{
+    return 63 - (x + y * 8);
+}
+
+constexpr int ChessSquareX(int Sq)
+{
+    return 7 - CHESS_FILE(Sq);
+}
+
+constexpr int ChessSquareY(int Sq)
+{
+    return 7 - CHESS_RANK(Sq);
+}
+
+/* Cell coordinates of a move's source and destination.                       */
+constexpr int MoveSx(ChessMove Move)
+{
+    return ChessSquareX(MoveFrom(Move));
+}
+
+constexpr int MoveSy(ChessMove Move)
+{
+    return ChessSquareY(MoveFrom(Move));
+}
+
+constexpr int MoveDx(ChessMove Move)
+{
+    return ChessSquareX(MoveTo(Move));
+}
+
+constexpr int MoveDy(ChessMove Move)
+{
+    return ChessSquareY(MoveTo(Move));
+}
+
 /******************************************************************************\
 * ChessInit                                                                    *
 *                                                                              *
@@ -47,9 +89,9 @@ void ChessInit();
 void ChessDraw();
 
 /******************************************************************************\
-* Board                                                                *
+* Board                                                                        *
 *                                                                              *
-*  Get a reference to the cell type at (x, y)                                  *
+*  Get the cell flags at (x, y), derived from the chess position.              *
 *                                                                              *
 * Parameters                                                                   *
 *                                                                              *
@@ -57,15 +99,63 @@ void ChessDraw();
 *                                                                              *
 * Return                                                                       *
 *                                                                              *
-*  -unsigned char&: A reference to the cell type at the position.              *
+*  -unsigned char: The CHESS_FLAG_* value of the cell, 0 if it's empty or out  *
+*                  of bounds.                                                  *
+*                                                                              *
+\******************************************************************************/
+unsigned char Board(int x, int y);
+
+/******************************************************************************\
+* ChessSetHighlight                                                            *
+*                                                                              *
+*  Replace the highlighted squares and clear any candidates. The mask is       *
+*  uploaded as its own texture channel, the pieces never carry UI state.       *
+*                                                                              *
+* Parameters                                                                   *
+*                                                                              *
+*  -Squares: The squares to highlight, BITBOARD_EMPTY clears them all.         *
+*                                                                              *
+* Return                                                                       *
+*                                                                              *
+*  -void.                                                                      *
+*                                                                              *
+\******************************************************************************/
+void ChessSetHighlight(Bitboard Squares);
+
+/******************************************************************************\
+* ChessSetCandidates                                                           *
+*                                                                              *
+*  Replace the highlight with the destinations of ranked candidate moves,      *
+*  shaded fainter the lower the rank. ChessSetHighlight clears them.           *
+*                                                                              *
+* Parameters                                                                   *
+*                                                                              *
+*  -Moves: The candidates, best first. CHESS_NO_MOVE entries are skipped.      *
+*  -Count: How many there are, past CHESS_MAX_CANDIDATES they are ignored.     *
+*                                                                              *
+* Return                                                                       *
+*                                                                              *
+*  -void.                                                                      *
+*                                                                              *
+\******************************************************************************/
+void ChessSetCandidates(const ChessMove *Moves, int Count);
+
+/******************************************************************************\
+* ChessGetPosition                                                             *
+*                                                                              *
+*  Get the position of the running game.                                       *
+*                                                                              *
+* Return                                                                       *
+*                                                                              *
+*  -ChessPosition*: The game's position.                                       *
 *                                                                              *
 \******************************************************************************/
-unsigned char &Board(int x, int y);
+ChessPosition *ChessGetPosition();
 
 /******************************************************************************\
 * ChessUploadBoard                                                             *
 *                                                                              *
-*  Upload the chess board to the GPU.                                          *
+*  Derive the cell flags from the position and upload them to the GPU.         *
 *                                                                              *
 * Return                                                                       *
 *                                                                              *
@@ -34,6 +34,26 @@
 /* Ticks Per Second.                                                          */
 #define EMBERS_TPS (120)
 
+/* Each side's chess clock, in seconds, and what every move adds back to it.  */
+/* The AI shares its own clock out between its moves.                         */
+#define EMBERS_CLOCK_SECONDS (300)
+#define EMBERS_CLOCK_INCREMENT (2)
+
+/* Threads the chess AI searches with, 0 for one per core but the one left    */
+/* to the render thread.                                                      */
+#define EMBERS_AI_THREADS (0)
+
+/* Root moves the chess AI finds lines for, 1 searches for the best move      */
+/* alone and plays strongest. Every line past the first costs depth.          */
+#define EMBERS_AI_LINES (1)
+
+/* Whether the first moves of the AI's lines are highlighted after it moves,  */
+/* only worth it with EMBERS_AI_LINES above 1.                                */
+#define EMBERS_AI_HIGHLIGHT (EMBERS_FALSE)
+
+/* The chess AI's transposition table size, in megabytes.                     */
+#define EMBERS_AI_HASH_MB (64)
+
 /* Small epsilon to account for floating point error.                         */
 #define EMBERS_EPSILON (1e-4)
 
@@ -44,23 +64,27 @@
 
 #define EMBERS_LOG_INFO(m)                          \
     do {                                            \
+        struct tm Local;                            \
         time_t tm = time(NULL);                     \
+        localtime_r(&tm, &Local);                   \
         fprintf(stdout,                             \
                 "<%d:%d:%d> [INFO] %s\n",           \
-                localtime(&tm) -> tm_hour,          \
-                localtime(&tm) -> tm_min,           \
-                localtime(&tm) -> tm_sec,           \
+                Local.tm_hour,                      \
+                Local.tm_min,                       \
+                Local.tm_sec,                       \
                 m);                                 \
     } while (0)
 
 #define EMBERS_LOG_ERROR(m)                         \
     do {                                            \
+        struct tm Local;                            \
         time_t tm = time(NULL);                     \
+        localtime_r(&tm, &Local);                   \
         fprintf(stderr,                             \
                 "<%d:%d:%d> [ERROR] %s\n",          \
-                localtime(&tm) -> tm_hour,          \
-                localtime(&tm) -> tm_min,           \
-                localtime(&tm) -> tm_sec,           \
+                Local.tm_hour,                      \
+                Local.tm_min,                       \
+                Local.tm_sec,                       \
                 m);                                 \
     } while (0)
 
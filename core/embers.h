@@ -25,6 +25,8 @@ typedef enum {
 	EMBERS_CANT_LINK_PROGRAM,
     EMBERS_OUT_OF_MEMORY,
     EMBERS_CANT_OPEN_FILE,
+    EMBERS_BAD_TABLES,
+    EMBERS_CANT_START_THREAD,
 	EMBERS_GL_ERROR = 0x100,
 } EmbersStatus;
 
@@ -21,7 +21,9 @@
 #include "mat4.h"
 #include "chess.h"
 #include <math.h>
-#include "moves.h"
+#include "movegen.h"
+#include "ai.h"
+#include "timeman.h"
 
 /**ERROR HANDLING**************************************************************/
 int EmbersExit = EMBERS_FALSE;
@@ -117,6 +119,14 @@ void ZoomUpdater(GLFWwindow* window, double xoffset, double yoffset)
 static void SetupState()
 {
     ChessInit();
+    if (EMBERS_IS_BAD_STATE())
+        return;
+
+    if (!AiStart()) {
+        EMBERS_ERROR(EMBERS_CANT_START_THREAD);
+        return;
+    }
+
     glfwSetScrollCallback(EmbersWindow, ZoomUpdater);
 }
 
@@ -127,8 +137,24 @@ static int cpx = -1,
            OldP = 0,
            CurrentTeam = -1;
 
-static unsigned short LegalMoves[1024];
-static int CurrentMove = 0;
+/* Moves of the selected piece, kept between clicks.                          */
+static MoveList Selected;
+
+/* Whether the AI has a search posted, and the key of the position it was     */
+/* posted for, its move is only played on that position.                      */
+static EMBERS_BOOL Thinking = EMBERS_FALSE;
+static ChessKey ThinkingKey;
+
+/* Set once the AI has no legal move, nothing is searched after that.         */
+static EMBERS_BOOL GameOver = EMBERS_FALSE;
+
+/* Seconds left to each side, by colour. Only the side to move's runs.        */
+static double Clocks[2] = {EMBERS_CLOCK_SECONDS, EMBERS_CLOCK_SECONDS};
+
+/* Whether the AI is searching PonderPos, the reply it expects, while the     */
+/* human thinks. Kept across ticks until the human has moved.                 */
+static EMBERS_BOOL Pondering = EMBERS_FALSE;
+static ChessPosition PonderPos;
 
 static inline int InBounds(int x, int y)
 {
@@ -139,113 +165,70 @@ static inline int GetTeam(int f)
     return (f & CHESS_FLAG_WHITE ? -1 : 1) * (f != 0);
 }
 
-static inline unsigned short PackMoves(unsigned char cpx,
-                                       unsigned char cpy,
-                                       unsigned char x,
-                                       unsigned char y)
+static inline void PerformMove(ChessMove Move)
 {
+    ChessPosition *Pos = ChessGetPosition();
 
-    if (!InBounds(x, y) || !InBounds(cpx, cpy))
-        return CHESS_END_MOVES;
+    Clocks[Pos -> SideToMove] += EMBERS_CLOCK_INCREMENT;
 
-    return cpx | (cpy << 3) | (x << 6) | (y << 9);
+    /* The game never takes a move back, its undo stack is only kept for      */
+    /* spotting repetitions, with room left for the search on top.            */
+    PositionMakeMove(Pos, Move);
+    PositionTrimHistory(Pos, CHESS_MAX_HISTORY - SEARCH_MAX_PLY);
 }
 
-static inline unsigned short UnpackSx(unsigned short Move)
+/* Highlight where the first move of each of the AI's lines goes, by rank.    */
+static void Candidates(const SearchResult *Result)
 {
-    return Move & 0x07;
-}
+    ChessMove Moves[SEARCH_MAX_LINES];
 
-static inline unsigned short UnpackSy(unsigned short Move)
-{
-    return (Move >> 3) & 0x07;
-}
+    for (int i = 0; i < Result -> LineCount; i++)
+        Moves[i] = Result -> Lines[i].PVLength ? Result -> Lines[i].PV[0] :
+                                                 CHESS_NO_MOVE;
 
-static inline unsigned short UnpackDx(unsigned short Move)
-{
-    return (Move >> 6) & 0x07;
+    ChessSetCandidates(Moves, Result -> LineCount);
 }
 
-static inline unsigned short UnpackDy(unsigned short Move)
+/* Start searching the position after the reply the AI's last search          */
+/* expects, on the human's time. Side is the AI's colour.                     */
+static void Ponder(const SearchResult *Result, int Side)
 {
-    return (Move >> 9) & 0x07;
-}
+    TimeControl Clock = {Clocks[Side], EMBERS_CLOCK_INCREMENT, 0};
+    SearchLimits Limits = {0, 0, 0, NULL};
 
-static inline void PerformMove(unsigned short Move)
-{
-    Board(UnpackDx(Move),
-          UnpackDy(Move)) = Board(UnpackSx(Move),
-                                  UnpackSy(Move));
+    if (Result -> PVLength < 2) {
+        EMBERS_LOG_INFO("AI has no expected reply to ponder on.");
+        return;
+    }
 
-    Board(UnpackSx(Move), UnpackSy(Move)) = 0;
+    PonderPos = *ChessGetPosition();
+    PositionMakeMove(&PonderPos, Result -> PV[1]);
+    TimeAllocate(&Clock, &Limits);
+    Pondering = AiPonder(&PonderPos, &Limits);
 }
 
-static void GenerateLegalMoves(int x, int y)
+/* Fill Out with the legal moves of the piece at (x, y) in Pos, only Pos and  */
+/* Out are touched.                                                           */
+static void GenerateLegalMoves(const ChessPosition *Pos,
+                               int x,
+                               int y,
+                               MoveList *Out)
 {
-    int j, k, a, b, Iters, NumMoves, Team;
-
-    unsigned char 
-        &CellVal = Board(x, y),
-         Type = (CellVal & 0xf0) >> 4;
-
-    if (!CellVal)
-        goto GEN_END;
-
-    NumMoves = MovesSizes[Type];
-    Iters = MovesIterate[Type] ? 8 : 1;
-    Team = GetTeam(CellVal);
-
-    if (Type << 4 == CHESS_FLAG_PAWN) {
-        if (InBounds(x, y + Team) && !Board(x, y + Team)) {
-            LegalMoves[CurrentMove++] = PackMoves(x, y, x, y + Team);
-
-            if (InBounds(x, y + Team * 2) && 
-                    !Board(x, y + Team*2) &&
-                    y == (Team == -1 ? 6 : 1))
-                LegalMoves[CurrentMove++] = PackMoves(x, y, x, y + Team * 2);
-
-        }
-
-        if (InBounds(x + Team, y + Team) &&
-                Board(x + Team, y + Team) &&
-                GetTeam(Board(x + Team, y + Team)) != Team)
-            LegalMoves[CurrentMove++] = PackMoves(x, y, x + Team, y + Team);
-
-        if (InBounds(x - Team, y + Team) &&
-                Board(x - Team, y + Team) &&
-                GetTeam(Board(x - Team, y + Team)) != Team)
-            LegalMoves[CurrentMove++] = PackMoves(x, y, x - Team, y + Team);
-
-        goto GEN_END;
-    }
-
-
-    for (j = 0; j < NumMoves; j++) {
-        for (k = 0; k < Iters; k++) {
-            a = MovesTemplates[Type][j][0] * (k + 1);
-            b = MovesTemplates[Type][j][1] * (k + 1);
-            if (!InBounds(x + a, y + b) || GetTeam(Board(x + a, y + b)) == Team) 
-                break;
-
-            LegalMoves[CurrentMove++] = PackMoves(x, y, x + a, y + b);
-
-            if (Board(x + a, y + b) && GetTeam(Board(x + a, y + b)) != Team)
-                break;
-        }
-    }
-
+    Out -> Count = 0;
+    if (!InBounds(x, y))
+        return;
 
-GEN_END:
-    LegalMoves[CurrentMove] = CHESS_END_MOVES;
+    MoveGenFrom(Pos, BITBOARD_SQUARE(ChessCellSquare(x, y)), Out);
 }
 
-static int ChessHandle(int x, int y)
+static int ChessHandle(const MoveList *Moves, int x, int y)
 {
-    for (int i = 0; LegalMoves[i] != CHESS_END_MOVES; i++) {
-        if (x != UnpackDx(LegalMoves[i]) || y != UnpackDy(LegalMoves[i]))
+    for (int i = 0; i < Moves -> Count; i++) {
+        if (x != MoveDx(Moves -> Moves[i]) ||
+                y != MoveDy(Moves -> Moves[i]))
             continue;
 
-        PerformMove(LegalMoves[i]);
+        PerformMove(Moves -> Moves[i]);
         return EMBERS_TRUE;
     }
 
@@ -258,10 +241,14 @@ static void UpdateState(int Tick, EMBERS_REAL Delta)
     double MouseDeltaX, MouseDeltaY,
            OldMouseX = MouseX,
            OldMouseY = MouseY;
+    int Side;
 
     glfwPollEvents();
     glfwGetCursorPos(EmbersWindow, &MouseX, &MouseY);
 
+    Side = ChessGetPosition() -> SideToMove;
+    Clocks[Side] = Clocks[Side] > Delta ? Clocks[Side] - Delta : 0;
+
     int Tx = MouseX / Zoom - (x + ((EMBERS_WIDTH / 2.f) / Zoom) ),
         Ty = MouseY / Zoom - (y + ((EMBERS_HEIGHT / 2.f) / Zoom) );
 
@@ -270,33 +257,29 @@ static void UpdateState(int Tick, EMBERS_REAL Delta)
 
     int P = glfwGetMouseButton(EmbersWindow, GLFW_MOUSE_BUTTON_1);
 
-    if (Tx >= 0 && Tx < 8 && Ty >= 0 && Ty < 8) {
+    /* The board only takes clicks on the human's turn, the AI's search must  */
+    /* never see its position change under it.                                */
+    if (CurrentTeam == -1 && !Thinking &&
+            Tx >= 0 && Tx < 8 && Ty >= 0 && Ty < 8) {
         if (P && !OldP) {
                 
             if (cpx != -1 && cpy != -1) {
-                Board(cpx, cpy) ^= CHESS_FLAG_HIGHLITED;
+                ChessSetHighlight(BITBOARD_EMPTY);
 
-                for (int i = 0; LegalMoves[i] != CHESS_END_MOVES; i++) {
-                    Board(UnpackDx(LegalMoves[i]),
-                          UnpackDy(LegalMoves[i])) ^= CHESS_FLAG_HIGHLITED;
-                }
-
-                if (ChessHandle(Tx, Ty))
+                if (ChessHandle(&Selected, Tx, Ty))
                     CurrentTeam = -CurrentTeam;
             }
 
             if (cpx == -1 && cpx == - 1 &&
                  GetTeam(Board(Tx, Ty)) == CurrentTeam) {
 
-                CurrentMove = 0;
-                GenerateLegalMoves(Tx, Ty);
+                Bitboard Highlight = BITBOARD_SQUARE(ChessCellSquare(Tx, Ty));
 
-                for (int i = 0; LegalMoves[i] != CHESS_END_MOVES; i++) {
-                    Board(UnpackDx(LegalMoves[i]),
-                          UnpackDy(LegalMoves[i])) |= CHESS_FLAG_HIGHLITED;
-                }
+                GenerateLegalMoves(ChessGetPosition(), Tx, Ty, &Selected);
+                for (int i = 0; i < Selected.Count; i++)
+                    Highlight |= BITBOARD_SQUARE(MoveTo(Selected.Moves[i]));
 
-                Board(Tx, Ty) |= CHESS_FLAG_HIGHLITED;
+                ChessSetHighlight(Highlight);
                 cpx = Tx;
                 cpy = Ty;
             } else {
@@ -309,17 +292,73 @@ static void UpdateState(int Tick, EMBERS_REAL Delta)
         OldP = P;
     }
 
-    if (CurrentTeam == 1) {
-        CurrentMove = 0;
-        for (int i = 0; i < 64; i++) {
-            for (int j = 0; j < 64; j++) {
-                if (Board(i, j) & CHESS_FLAG_BLACK)
-                    GenerateLegalMoves(i, j);
+    /* The AI searches on its own thread, the loop only checks in on it. A    */
+    /* click above may have just handed it the move, so the side is read      */
+    /* again for the AI's clock to be the one budgeted from.                  */
+    Side = ChessGetPosition() -> SideToMove;
+    if (CurrentTeam == 1 && !GameOver) {
+        TimeControl Clock = {Clocks[Side], EMBERS_CLOCK_INCREMENT, 0};
+        SearchLimits Limits = {0, 0, 0, NULL};
+        SearchResult Result;
+        char Report[EMBERS_BUFFER_SIZE];
+
+        /* The human has moved, a right guess keeps what was searched so far, */
+        /* a wrong one is thrown away but leaves its table entries behind.    */
+        if (Pondering) {
+            Pondering = EMBERS_FALSE;
+            if (ChessGetPosition() -> Key == PonderPos.Key) {
+                AiPonderHit();
+                Thinking = EMBERS_TRUE;
+                ThinkingKey = PonderPos.Key;
+                EMBERS_LOG_INFO("AI ponder hit.");
+            } else {
+                AiCancel();
+                EMBERS_LOG_INFO("AI ponder miss.");
             }
         }
 
-        PerformMove(LegalMoves[rand() % CurrentMove]);
-        CurrentTeam = -CurrentTeam;
+        if (!Thinking) {
+            TimeAllocate(&Clock, &Limits);
+            Thinking = AiThink(ChessGetPosition(), &Limits);
+            ThinkingKey = ChessGetPosition() -> Key;
+        } else if (AiPoll(&Result)) {
+            Thinking = EMBERS_FALSE;
+
+            /* No legal moves means the game is over. A move searched on      */
+            /* another position could corrupt the board, it's searched again. */
+            if (Result.Best == CHESS_NO_MOVE) {
+                GameOver = EMBERS_TRUE;
+                EMBERS_LOG_INFO(MoveGenInCheck(ChessGetPosition()) ?
+                                "Game over, the AI is checkmated." :
+                                "Game over, stalemate.");
+            } else if (ChessGetPosition() -> Key != ThinkingKey ||
+                       !MoveGenIsLegal(ChessGetPosition(), Result.Best)) {
+                EMBERS_LOG_ERROR("AI move doesn't fit the board, searching "
+                                 "again.");
+            } else {
+                snprintf(Report,
+                         sizeof(Report),
+                         "AI depth %d score %d, %llu nodes in %.2fs, %.0f nps, "
+                         "%.0f%% hash hits, hash %d/1000 full, "
+                         "%.1fs left",
+                         Result.Depth,
+                         Result.Score,
+                         Result.Nodes,
+                         Result.Seconds,
+                         SearchNPS(&Result),
+                         SearchHitRate(&Result) * 100,
+                         Result.Fill,
+                         Clocks[Side]);
+                EMBERS_LOG_INFO(Report);
+
+                PerformMove(Result.Best);
+                CurrentTeam = -CurrentTeam;
+                if (EMBERS_AI_HIGHLIGHT)
+                    Candidates(&Result);
+
+                Ponder(&Result, Side);
+            }
+        }
     }
 
 
@@ -345,6 +384,7 @@ static void RenderFrame(unsigned Frame, EMBERS_REAL Delta)
 
 static void CleanupState() 
 {
+    AiShutdown();
     ChessShutdown();
 }
 
@@ -432,6 +472,8 @@ static const char
     "Couldn't link program.",
     "Out of memory.",
     "Couldn't open a file.",
+    "Attack tables failed the self-check.",
+    "Couldn't start the AI thread.",
     "Hit an openGL error."
 };
 
@@ -488,9 +530,11 @@ static void WriteReport()
     char Buff[EMBERS_BUFFER_SIZE];
     snprintf(Buff,
              EMBERS_BUFFER_SIZE,
-             "FPS: %3d   TPS: %3d",
+             "FPS: %3d   TPS: %3d   Clocks: %.1fs %.1fs",
              CurrentFPS,
-             CurrentTPS);
+             CurrentTPS,
+             Clocks[CHESS_WHITE],
+             Clocks[CHESS_BLACK]);
 
     EMBERS_LOG_INFO(Buff);
 }
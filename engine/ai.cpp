@@ -0,0 +1,207 @@
+#include "ai.h"
+#include <pthread.h>
+#include <semaphore.h>
+#include <sched.h>
+#include <stdio.h>
+#include <unistd.h>
+
+static struct Ai {
+    pthread_t Thread;
+    sem_t Wake; /* Posted once per search and once to quit.                   */
+    int State; /* AI_*, atomic.                                               */
+    int Stop; /* Atomic, read by the search.                                  */
+    int Pondering; /* Atomic, holds the search's time limits back.            */
+    EMBERS_BOOL Running;
+    EMBERS_BOOL Cancelled; /* The search running is to be thrown away.        */
+    int Threads; /* Atomic, read when a search starts.                        */
+    int Pruning; /* Atomic, copied into the main context per search.          */
+    int Lines; /* Atomic, likewise.                                           */
+    TTable Table; /* Kept across searches.                                    */
+
+    /* The mailbox, written by whoever owns the state.                        */
+    ChessPosition Pos;
+    SearchLimits Limits;
+    SearchResult Result;
+    SearchContext Search[SEARCH_MAX_THREADS];
+} Ai;
+
+static void *Worker(void *Data);
+static void Report(const SearchResult *Result);
+static void Discard();
+
+/* Log each finished iteration, so the cost of every depth shows.             */
+void Report(const SearchResult *Result)
+{
+    char Line[128];
+
+    snprintf(Line,
+             sizeof(Line),
+             "AI iteration depth %d score %d, %llu nodes in %.2fs",
+             Result -> Depth,
+             Result -> Score,
+             Result -> Nodes,
+             Result -> Seconds);
+    EMBERS_LOG_INFO(Line);
+}
+
+/* Throw a cancelled search's result away once the worker is done with it.    */
+void Discard()
+{
+    if (Ai.Cancelled &&
+        __atomic_load_n(&Ai.State, __ATOMIC_ACQUIRE) == AI_DONE) {
+        Ai.Cancelled = EMBERS_FALSE;
+        __atomic_store_n(&Ai.State, AI_IDLE, __ATOMIC_RELEASE);
+    }
+}
+
+void *Worker(void *Data)
+{
+    for (;;) {
+        sem_wait(&Ai.Wake);
+        if (__atomic_load_n(&Ai.State, __ATOMIC_ACQUIRE) == AI_QUIT)
+            return NULL;
+
+        Ai.Search[0].Pruning = __atomic_load_n(&Ai.Pruning, __ATOMIC_RELAXED);
+        Ai.Search[0].MultiPV = __atomic_load_n(&Ai.Lines, __ATOMIC_RELAXED);
+        SearchParallel(Ai.Search,
+                       __atomic_load_n(&Ai.Threads, __ATOMIC_RELAXED),
+                       &Ai.Pos,
+                       &Ai.Limits,
+                       &Ai.Result);
+        __atomic_store_n(&Ai.State, AI_DONE, __ATOMIC_RELEASE);
+    }
+}
+
+EMBERS_BOOL AiStart()
+{
+    Ai.State = AI_IDLE;
+    Ai.Stop = EMBERS_FALSE;
+    AiSetThreads(EMBERS_AI_THREADS);
+
+    if (!TTCreate(&Ai.Table, EMBERS_AI_HASH_MB))
+        return EMBERS_FALSE;
+
+    Ai.Search[0].Table = &Ai.Table;
+    Ai.Search[0].Report = Report;
+    AiSetPruning(SEARCH_PRUNE_ALL);
+    AiSetLines(EMBERS_AI_LINES);
+    if (sem_init(&Ai.Wake, 0, 0)) {
+        TTFree(&Ai.Table);
+        return EMBERS_FALSE;
+    }
+
+    if (pthread_create(&Ai.Thread, NULL, Worker, NULL)) {
+        sem_destroy(&Ai.Wake);
+        TTFree(&Ai.Table);
+        return EMBERS_FALSE;
+    }
+
+    Ai.Running = EMBERS_TRUE;
+    return EMBERS_TRUE;
+}
+
+void AiShutdown()
+{
+    if (!Ai.Running)
+        return;
+
+    /* A running search sees the stop flag, an idle worker the quit state.    */
+    AiStop();
+    while (__atomic_load_n(&Ai.State, __ATOMIC_ACQUIRE) == AI_THINKING)
+        sched_yield();
+
+    __atomic_store_n(&Ai.State, AI_QUIT, __ATOMIC_RELEASE);
+    sem_post(&Ai.Wake);
+    pthread_join(Ai.Thread, NULL);
+    sem_destroy(&Ai.Wake);
+    TTFree(&Ai.Table);
+    Ai.Running = EMBERS_FALSE;
+}
+
+EMBERS_BOOL AiThink(const ChessPosition *Pos, const SearchLimits *Limits)
+{
+    Discard();
+    if (__atomic_load_n(&Ai.State, __ATOMIC_ACQUIRE) != AI_IDLE)
+        return EMBERS_FALSE;
+
+    Ai.Pos = *Pos;
+    Ai.Limits = *Limits;
+    Ai.Limits.Stop = &Ai.Stop;
+    Ai.Limits.Ponder = &Ai.Pondering;
+    __atomic_store_n(&Ai.Stop, EMBERS_FALSE, __ATOMIC_RELAXED);
+
+    __atomic_store_n(&Ai.State, AI_THINKING, __ATOMIC_RELEASE);
+    sem_post(&Ai.Wake);
+    return EMBERS_TRUE;
+}
+
+EMBERS_BOOL AiPonder(const ChessPosition *Pos, const SearchLimits *Limits)
+{
+    Discard();
+    if (__atomic_load_n(&Ai.State, __ATOMIC_ACQUIRE) != AI_IDLE)
+        return EMBERS_FALSE;
+
+    __atomic_store_n(&Ai.Pondering, EMBERS_TRUE, __ATOMIC_RELAXED);
+    return AiThink(Pos, Limits);
+}
+
+void AiPonderHit()
+{
+    __atomic_store_n(&Ai.Pondering, EMBERS_FALSE, __ATOMIC_RELAXED);
+}
+
+EMBERS_BOOL AiPoll(SearchResult *Result)
+{
+    Discard();
+    if (__atomic_load_n(&Ai.State, __ATOMIC_ACQUIRE) != AI_DONE)
+        return EMBERS_FALSE;
+
+    *Result = Ai.Result;
+    __atomic_store_n(&Ai.State, AI_IDLE, __ATOMIC_RELEASE);
+    return EMBERS_TRUE;
+}
+
+void AiStop()
+{
+    __atomic_store_n(&Ai.Stop, EMBERS_TRUE, __ATOMIC_RELAXED);
+}
+
+void AiCancel()
+{
+    if (__atomic_load_n(&Ai.State, __ATOMIC_ACQUIRE) == AI_IDLE)
+        return;
+
+    AiStop();
+    __atomic_store_n(&Ai.Pondering, EMBERS_FALSE, __ATOMIC_RELAXED);
+    Ai.Cancelled = EMBERS_TRUE;
+    Discard();
+}
+
+void AiSetThreads(int Threads)
+{
+    /* The worker and its helpers leave the game loop a core of its own.      */
+    if (Threads <= 0)
+        Threads = (int)sysconf(_SC_NPROCESSORS_ONLN) - 1;
+
+    if (Threads < 1)
+        Threads = 1;
+    else if (Threads > SEARCH_MAX_THREADS)
+        Threads = SEARCH_MAX_THREADS;
+
+    __atomic_store_n(&Ai.Threads, Threads, __ATOMIC_RELAXED);
+}
+
+void AiSetPruning(int Pruning)
+{
+    __atomic_store_n(&Ai.Pruning, Pruning, __ATOMIC_RELAXED);
+}
+
+void AiSetLines(int Lines)
+{
+    if (Lines < 1)
+        Lines = 1;
+    else if (Lines > SEARCH_MAX_LINES)
+        Lines = SEARCH_MAX_LINES;
+
+    __atomic_store_n(&Ai.Lines, Lines, __ATOMIC_RELAXED);
+}
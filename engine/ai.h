@@ -0,0 +1,192 @@
+/******************************************************************************\
+*  ai.h                                                                        *
+*                                                                              *
+*  Runs the search on a worker thread so the game loop never waits on it.      *
+*  The game posts a position and polls for the move, the two threads only      *
+*  share a mailbox whose state is changed atomically.                          *
+*                                                                              *
+*              Written by Abed Na'ran                          October 2026    *
+*                                                                              *
+\******************************************************************************/
+#ifndef AI_H
+#define AI_H
+#include "search.h"
+
+/* The mailbox states, each one is left by one side only.                     */
+enum {
+    AI_IDLE = 0, /* Empty, the game may post.                                 */
+    AI_THINKING, /* Owned by the worker.                                      */
+    AI_DONE, /* The result is in, the game may take it.                       */
+    AI_QUIT
+};
+
+/******************************************************************************\
+* AiStart                                                                      *
+*                                                                              *
+*  Start the worker thread and allocate its transposition table, searching     *
+*  with EMBERS_AI_THREADS threads until AiSetThreads says otherwise.           *
+*                                                                              *
+* Return                                                                       *
+*                                                                              *
+*  -EMBERS_BOOL: EMBERS_FALSE if the thread or table couldn't be made.         *
+*                                                                              *
+\******************************************************************************/
+EMBERS_BOOL AiStart();
+
+/******************************************************************************\
+* AiShutdown                                                                   *
+*                                                                              *
+*  Stop any search and join the worker thread.                                 *
+*                                                                              *
+* Return                                                                       *
+*                                                                              *
+*  -void.                                                                      *
+*                                                                              *
+\******************************************************************************/
+void AiShutdown();
+
+/******************************************************************************\
+* AiThink                                                                      *
+*                                                                              *
+*  Post a position to search. The position is copied so the caller may keep    *
+*  changing its own.                                                           *
+*                                                                              *
+* Parameters                                                                   *
+*                                                                              *
+*  -Pos: The position.                                                         *
+*  -Limits: When to stop, its Stop flag is replaced by the worker's own.       *
+*                                                                              *
+* Return                                                                       *
+*                                                                              *
+*  -EMBERS_BOOL: EMBERS_FALSE if the worker is still busy.                     *
+*                                                                              *
+\******************************************************************************/
+EMBERS_BOOL AiThink(const ChessPosition *Pos, const SearchLimits *Limits);
+
+/******************************************************************************\
+* AiPonder                                                                     *
+*                                                                              *
+*  Post the position the AI expects to face next, to search on the             *
+*  opponent's time. The time limits wait until AiPonderHit, or the search is   *
+*  thrown away with AiCancel. The table it fills is kept either way.           *
+*                                                                              *
+* Parameters                                                                   *
+*                                                                              *
+*  -Pos: The predicted position.                                               *
+*  -Limits: As AiThink, counted from now, so the time spent pondering is       *
+*  charged to the move once the ponder hits.                                   *
+*                                                                              *
+* Return                                                                       *
+*                                                                              *
+*  -EMBERS_BOOL: EMBERS_FALSE if the worker is still busy.                     *
+*                                                                              *
+\******************************************************************************/
+EMBERS_BOOL AiPonder(const ChessPosition *Pos, const SearchLimits *Limits);
+
+/******************************************************************************\
+* AiPonderHit                                                                  *
+*                                                                              *
+*  The predicted move was played, the ponder search carries on as a normal     *
+*  one and its result is taken with AiPoll.                                    *
+*                                                                              *
+* Return                                                                       *
+*                                                                              *
+*  -void.                                                                      *
+*                                                                              *
+\******************************************************************************/
+void AiPonderHit();
+
+/******************************************************************************\
+* AiPoll                                                                       *
+*                                                                              *
+*  Take the result of the last search if it's finished, never blocks.          *
+*                                                                              *
+* Parameters                                                                   *
+*                                                                              *
+*  -Result: Out, the finished search.                                          *
+*                                                                              *
+* Return                                                                       *
+*                                                                              *
+*  -EMBERS_BOOL: EMBERS_TRUE if a result was taken.                            *
+*                                                                              *
+\******************************************************************************/
+EMBERS_BOOL AiPoll(SearchResult *Result);
+
+/******************************************************************************\
+* AiStop                                                                       *
+*                                                                              *
+*  Ask the running search to finish early, its result is still posted.         *
+*                                                                              *
+* Return                                                                       *
+*                                                                              *
+*  -void.                                                                      *
+*                                                                              *
+\******************************************************************************/
+void AiStop();
+
+/******************************************************************************\
+* AiCancel                                                                     *
+*                                                                              *
+*  Stop the running search and throw its result away, never blocks. The        *
+*  worker is busy until the search sees the stop flag, AiThink and AiPonder    *
+*  return EMBERS_FALSE and AiPoll takes nothing until then.                    *
+*                                                                              *
+* Return                                                                       *
+*                                                                              *
+*  -void.                                                                      *
+*                                                                              *
+\******************************************************************************/
+void AiCancel();
+
+/******************************************************************************\
+* AiSetThreads                                                                 *
+*                                                                              *
+*  Change how many threads the AI searches with, from the next search on.      *
+*  Searching on every core would starve the game loop, pondering included.     *
+*                                                                              *
+* Parameters                                                                   *
+*                                                                              *
+*  -Threads: The thread count, 0 or less for every core but one.               *
+*                                                                              *
+* Return                                                                       *
+*                                                                              *
+*  -void.                                                                      *
+*                                                                              *
+\******************************************************************************/
+void AiSetThreads(int Threads);
+
+/******************************************************************************\
+* AiSetPruning                                                                 *
+*                                                                              *
+*  Turn the selective search techniques on or off, from the next search on.    *
+*  All of them are on after AiStart.                                           *
+*                                                                              *
+* Parameters                                                                   *
+*                                                                              *
+*  -Pruning: The SEARCH_* techniques to use.                                   *
+*                                                                              *
+* Return                                                                       *
+*                                                                              *
+*  -void.                                                                      *
+*                                                                              *
+\******************************************************************************/
+void AiSetPruning(int Pruning);
+
+/******************************************************************************\
+* AiSetLines                                                                   *
+*                                                                              *
+*  Change how many of the best root moves the AI finds lines for, from the     *
+*  next search on. EMBERS_AI_LINES after AiStart.                              *
+*                                                                              *
+* Parameters                                                                   *
+*                                                                              *
+*  -Lines: The line count, clamped to 1 to SEARCH_MAX_LINES.                   *
+*                                                                              *
+* Return                                                                       *
+*                                                                              *
+*  -void.                                                                      *
+*                                                                              *
+\******************************************************************************/
+void AiSetLines(int Lines);
+
+#endif /* AI_H */
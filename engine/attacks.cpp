@@ -0,0 +1,207 @@
+#include "attacks.h"
+#include "position.h"
+#include "moves.h"
+
+/* Sizes of the shared tables, the sum of 2^bits(Mask) over every square.     */
+#define ROOK_TABLE_SIZE (0x19000)
+#define BISHOP_TABLE_SIZE (0x1480)
+
+AttacksMagic AttacksRookMagics[64];
+AttacksMagic AttacksBishopMagics[64];
+
+static Bitboard RookTable[ROOK_TABLE_SIZE];
+static Bitboard BishopTable[BISHOP_TABLE_SIZE];
+
+/* Found offline with a sparse random search over every square, searching at  */
+/* startup took most of a second. Unused when indexing with PEXT.             */
+static const Bitboard
+    RookMagics[64] = {
+    0x1080004008801020ULL, 0x0840092002c03000ULL, 0x1900200010400900ULL,
+    0x0880100008000480ULL, 0x4200100420080200ULL, 0x8100020100080400ULL,
+    0x0200040110886200ULL, 0x0200008040220411ULL, 0x0404800084400220ULL,
+    0x0000401000402000ULL, 0x0086001081220440ULL, 0x0408800800100280ULL,
+    0x000a001201040820ULL, 0x8848800200840080ULL, 0x4001000100040200ULL,
+    0x0442000102105084ULL, 0x9080010020804100ULL, 0x0040404000201009ULL,
+    0x0000808010002009ULL, 0x2200090021d00100ULL, 0x0008008008040080ULL,
+    0x0004004002010040ULL, 0x0011040008015042ULL, 0x00000a0001768104ULL,
+    0x0000800080204009ULL, 0x2010004140002001ULL, 0x9800200280100080ULL,
+    0x1000100080080080ULL, 0x0442000a00049020ULL, 0x2100040080020080ULL,
+    0x0800120400900148ULL, 0x0010040a00128541ULL, 0x2800804000800030ULL,
+    0x1010002000400041ULL, 0x4000200011004100ULL, 0x0610008410800800ULL,
+    0x0400802402800800ULL, 0xc100020080800400ULL, 0x0002000802000401ULL,
+    0x0182085882000401ULL, 0x0220204000808000ULL, 0x2860100040024022ULL,
+    0x0001002004110040ULL, 0x99101042000a0020ULL, 0x0004080004008080ULL,
+    0x0010040002008080ULL, 0x2012004881020004ULL, 0x8300842444820011ULL,
+    0x0088403882010200ULL, 0x0820400080210100ULL, 0x0110910040a00300ULL,
+    0x0801100280080480ULL, 0x0242009008200600ULL, 0x1002000489500200ULL,
+    0x0040800200010080ULL, 0x0091800041000080ULL, 0x0000209300488001ULL,
+    0x04c1002414824001ULL, 0x020020000b001041ULL, 0x7000100004200901ULL,
+    0x8002002004100802ULL, 0x30010002084c0007ULL, 0x0888221800813004ULL,
+    0x4000002840840112ULL
+    };
+
+static const Bitboard
+    BishopMagics[64] = {
+    0x1010900200902200ULL, 0x0260046086204080ULL, 0x0804087081012c80ULL,
+    0x0008208a240a1084ULL, 0x0004042080020020ULL, 0x8019100210008080ULL,
+    0x0400480444212004ULL, 0xa200240c02882800ULL, 0xa0a0042008410102ULL,
+    0x064a08010802004aULL, 0x0008080204322440ULL, 0x0031280600400200ULL,
+    0x0000240504100c00ULL, 0x1404020804040400ULL, 0x39a0042104022012ULL,
+    0x0000802092101005ULL, 0x0010602420021c44ULL, 0x2020000802841044ULL,
+    0x15c0800802031022ULL, 0x0084000804240800ULL, 0x0013002820080001ULL,
+    0x050102008080c008ULL, 0x8040882062082000ULL, 0x5001840044208810ULL,
+    0x0002400110108201ULL, 0x0110080022424421ULL, 0x0800a60410040844ULL,
+    0x1144040080410200ULL, 0x0106001002005001ULL, 0x1811050012048080ULL,
+    0x80020c0800410800ULL, 0x8001204011040880ULL, 0x048484404a200284ULL,
+    0x0000901004040480ULL, 0x5224004800210204ULL, 0x05a6008020020201ULL,
+    0x0010220200002008ULL, 0x0632080201404044ULL, 0x100801004c010818ULL,
+    0x0011012601a10444ULL, 0x0004112441071021ULL, 0x8812021004060314ULL,
+    0x0000082690000801ULL, 0xc000020212000400ULL, 0x0000084104002442ULL,
+    0x0081100101100200ULL, 0x7288816102018404ULL, 0x9408008c0048208aULL,
+    0x08040c0208440200ULL, 0x0000440088080400ULL, 0x00200d0290d00160ULL,
+    0x4000000020880008ULL, 0x000840a002048001ULL, 0x0001204410208400ULL,
+    0x4040880280861288ULL, 0x20103c0800604100ULL, 0x050841040101c000ULL,
+    0x2020102401241040ULL, 0x4a12000024020800ULL, 0x3201000c00420200ULL,
+    0xa559000004050408ULL, 0x1102440892080a10ULL, 0x0400402849046080ULL,
+    0x0060111001090121ULL
+    };
+
+static constexpr Bitboard WalkRays(int Type, int Sq, Bitboard Occ);
+static constexpr AttacksTables BuildTables();
+static void InitSlider(int Type,
+                       const Bitboard *Candidates,
+                       AttacksMagic *Magics,
+                       Bitboard *Table);
+
+/* The reference walker, steps along the MovesTemplates rays one square at a  */
+/* time and stops at the first blocker.                                       */
+constexpr Bitboard WalkRays(int Type, int Sq, Bitboard Occ)
+{
+    Bitboard Attacks = 0, Bit = 0;
+    int Steps = MovesIterate[Type] ? 8 : 1,
+        File = 0, Rank = 0;
+
+    for (int j = 0; j < MovesSizes[Type]; j++) {
+        for (int k = 1; k <= Steps; k++) {
+            File = CHESS_FILE(Sq) + MovesTemplates[Type][j][0] * k;
+            Rank = CHESS_RANK(Sq) + MovesTemplates[Type][j][1] * k;
+
+            if (File < 0 || Rank < 0 || File >= 8 || Rank >= 8)
+                break;
+
+            Bit = BITBOARD_SQUARE(CHESS_SQUARE(File, Rank));
+            Attacks |= Bit;
+            if (Occ & Bit)
+                break;
+        }
+    }
+
+    return Attacks;
+}
+
+void InitSlider(int Type,
+                const Bitboard *Candidates,
+                AttacksMagic *Magics,
+                Bitboard *Table)
+{
+    for (int Sq = 0; Sq < 64; Sq++) {
+        AttacksMagic *Entry = &Magics[Sq];
+        Bitboard Edges = ((BITBOARD_RANK_1 | BITBOARD_RANK_8) &
+                          ~(BITBOARD_RANK_1 << (CHESS_RANK(Sq) * 8))) |
+                         ((BITBOARD_FILE_A | BITBOARD_FILE_H) &
+                          ~(BITBOARD_FILE_A << CHESS_FILE(Sq))),
+                 Subset = 0;
+
+        Entry -> Mask = WalkRays(Type, Sq, 0) & ~Edges;
+        Entry -> Magic = Candidates[Sq];
+        Entry -> Shift = 64 - BitboardCount(Entry -> Mask);
+        Entry -> Table = Sq ? Magics[Sq - 1].Table +
+                              (1 << (64 - Magics[Sq - 1].Shift)) : Table;
+
+        /* Carry-Rippler trick to enumerate every subset of the mask.         */
+        do {
+            Entry -> Table[AttacksIndex(Entry, Subset)] =
+                WalkRays(Type, Sq, Subset);
+            Subset = (Subset - Entry -> Mask) & Entry -> Mask;
+        } while (Subset);
+    }
+}
+
+constexpr AttacksTables BuildTables()
+{
+    AttacksTables Tables = {};
+
+    for (int Sq = 0; Sq < 64; Sq++) {
+        Bitboard Bit = BITBOARD_SQUARE(Sq),
+                 Rook = WalkRays(CHESS_ROOK, Sq, 0),
+                 Bishop = WalkRays(CHESS_BISHOP, Sq, 0);
+
+        Tables.Knight[Sq] = WalkRays(CHESS_KNIGHT, Sq, 0);
+        Tables.King[Sq] = WalkRays(CHESS_KING, Sq, 0);
+        Tables.Pawn[CHESS_WHITE][Sq] = ((Bit & ~BITBOARD_FILE_A) << 7) |
+                                       ((Bit & ~BITBOARD_FILE_H) << 9);
+        Tables.Pawn[CHESS_BLACK][Sq] = ((Bit & ~BITBOARD_FILE_A) >> 9) |
+                                       ((Bit & ~BITBOARD_FILE_H) >> 7);
+
+        /* Two aligned squares see each other's ray, the overlap of the two   */
+        /* rays with each square blocking the other is what's between.        */
+        for (int To = 0; To < 64; To++) {
+            Bitboard ToBit = BITBOARD_SQUARE(To);
+
+            if (Rook & ToBit) {
+                Tables.Line[Sq][To] = (Rook & WalkRays(CHESS_ROOK, To, 0)) |
+                                      Bit | ToBit;
+                Tables.Between[Sq][To] = WalkRays(CHESS_ROOK, Sq, ToBit) &
+                                         WalkRays(CHESS_ROOK, To, Bit);
+            } else if (Bishop & ToBit) {
+                Tables.Line[Sq][To] = (Bishop & WalkRays(CHESS_BISHOP, To, 0)) |
+                                      Bit | ToBit;
+                Tables.Between[Sq][To] = WalkRays(CHESS_BISHOP, Sq, ToBit) &
+                                         WalkRays(CHESS_BISHOP, To, Bit);
+            }
+        }
+    }
+
+    return Tables;
+}
+
+constexpr AttacksTables AttacksStatic = BuildTables();
+
+void AttacksInit()
+{
+    InitSlider(CHESS_ROOK, RookMagics, AttacksRookMagics, RookTable);
+    InitSlider(CHESS_BISHOP, BishopMagics, AttacksBishopMagics, BishopTable);
+}
+
+EMBERS_BOOL AttacksSelfCheck()
+{
+    Bitboard Noise = 0x2545f4914f6cdd1dULL;
+
+    for (int Sq = 0; Sq < 64; Sq++) {
+        Bitboard RookMask = AttacksRookMagics[Sq].Mask,
+                 BishopMask = AttacksBishopMagics[Sq].Mask,
+                 Subset = 0;
+
+        /* Bits outside the mask must not change the lookup, so every subset  */
+        /* is checked with some noise around it.                              */
+        do {
+            Noise = Noise * 6364136223846793005ULL + 1442695040888963407ULL;
+            if (AttacksRook(Sq, Subset | (Noise & ~RookMask)) !=
+                    WalkRays(CHESS_ROOK, Sq, Subset))
+                return EMBERS_FALSE;
+
+            Subset = (Subset - RookMask) & RookMask;
+        } while (Subset);
+
+        do {
+            Noise = Noise * 6364136223846793005ULL + 1442695040888963407ULL;
+            if (AttacksBishop(Sq, Subset | (Noise & ~BishopMask)) !=
+                    WalkRays(CHESS_BISHOP, Sq, Subset))
+                return EMBERS_FALSE;
+
+            Subset = (Subset - BishopMask) & BishopMask;
+        } while (Subset);
+    }
+
+    return EMBERS_TRUE;
+}
@@ -0,0 +1,109 @@
+/******************************************************************************\
+*  attacks.h                                                                   *
+*                                                                              *
+*  Precomputed attack tables. Sliding pieces are looked up through magic       *
+*  bitboards, or PEXT when BMI2 is available, so a rook, bishop or queen       *
+*  attack set costs one multiply, one shift and one load.                      *
+*                                                                              *
+*              Written by Abed Na'ran                          October 2026    *
+*                                                                              *
+\******************************************************************************/
+#ifndef ATTACKS_H
+#define ATTACKS_H
+#include "config.h"
+#include "bitboard.h"
+
+#ifdef __BMI2__
+#include <immintrin.h>
+#endif
+
+typedef struct AttacksMagic {
+    Bitboard Mask; /* Relevant occupancy, board edges excluded.               */
+    Bitboard Magic;
+    Bitboard *Table; /* This square's slice of the shared attack table.       */
+    int Shift;
+} AttacksMagic;
+
+extern AttacksMagic AttacksRookMagics[64];
+extern AttacksMagic AttacksBishopMagics[64];
+
+/* The tables that don't depend on occupancy, built at compile time and kept  */
+/* together in read-only memory, each one starting on a cache line.           */
+typedef struct alignas(64) AttacksTables {
+    Bitboard Knight[64];
+    Bitboard King[64];
+    Bitboard Pawn[2][64]; /* Squares a pawn of each colour hits.              */
+
+    /* Squares strictly between two aligned squares, empty if they aren't.    */
+    Bitboard Between[64][64];
+
+    /* The full edge to edge line through two aligned squares, empty if they  */
+    /* aren't.                                                                */
+    Bitboard Line[64][64];
+} AttacksTables;
+
+extern const AttacksTables AttacksStatic;
+
+static constexpr const Bitboard (&AttacksKnight)[64] = AttacksStatic.Knight;
+static constexpr const Bitboard (&AttacksKing)[64] = AttacksStatic.King;
+static constexpr const Bitboard (&AttacksPawn)[2][64] = AttacksStatic.Pawn;
+static constexpr const Bitboard (&AttacksBetween)[64][64] =
+    AttacksStatic.Between;
+static constexpr const Bitboard (&AttacksLine)[64][64] =
+    AttacksStatic.Line;
+
+/******************************************************************************\
+* AttacksInit                                                                  *
+*                                                                              *
+*  Build the slider tables, must be called once at startup before any rook,    *
+*  bishop or queen lookup. The other tables need no setup.                     *
+*                                                                              *
+* Return                                                                       *
+*                                                                              *
+*  -void.                                                                      *
+*                                                                              *
+\******************************************************************************/
+void AttacksInit();
+
+/******************************************************************************\
+* AttacksSelfCheck                                                             *
+*                                                                              *
+*  Compare the slider tables against the MovesTemplates ray walker for every   *
+*  square and every subset of its relevant occupancy.                          *
+*                                                                              *
+* Return                                                                       *
+*                                                                              *
+*  -EMBERS_BOOL: EMBERS_TRUE if every lookup matched.                          *
+*                                                                              *
+\******************************************************************************/
+EMBERS_BOOL AttacksSelfCheck();
+
+static inline unsigned AttacksIndex(const AttacksMagic *Entry, Bitboard Occ)
+{
+#ifdef __BMI2__
+    return (unsigned)_pext_u64(Occ, Entry -> Mask);
+#else
+    return (unsigned)(((Occ & Entry -> Mask) * Entry -> Magic) >> Entry -> Shift);
+#endif
+}
+
+static inline Bitboard AttacksRook(int Sq, Bitboard Occ)
+{
+    const AttacksMagic *Entry = &AttacksRookMagics[Sq];
+
+    return Entry -> Table[AttacksIndex(Entry, Occ)];
+}
+
+static inline Bitboard AttacksBishop(int Sq, Bitboard Occ)
+{
+    const AttacksMagic *Entry = &AttacksBishopMagics[Sq];
+
+    return Entry -> Table[AttacksIndex(Entry, Occ)];
+}
+
+static inline Bitboard AttacksQueen(int Sq, Bitboard Occ)
+{
+    return AttacksRook(Sq, Occ) | AttacksBishop(Sq, Occ);
+}
+
+#endif /* ATTACKS_H */
@@ -0,0 +1,58 @@
+/******************************************************************************\
+*  bitboard.h                                                                  *
+*                                                                              *
+*  64-bit board sets and the square helpers used by the chess engine.          *
+*  Squares are numbered a1 = 0 through h8 = 63, one bit per square.            *
+*                                                                              *
+*              Written by Abed Na'ran                          October 2026    *
+*                                                                              *
+\******************************************************************************/
+#ifndef BITBOARD_H
+#define BITBOARD_H
+#include <stdint.h>
+
+typedef uint64_t Bitboard;
+
+#define CHESS_NO_SQUARE (64)
+
+#define BITBOARD_EMPTY ((Bitboard)0)
+#define BITBOARD_FULL (~(Bitboard)0)
+#define BITBOARD_SQUARE(Sq) ((Bitboard)1 << (Sq))
+
+#define BITBOARD_FILE_A ((Bitboard)0x0101010101010101ULL)
+#define BITBOARD_FILE_H (BITBOARD_FILE_A << 7)
+#define BITBOARD_RANK_1 ((Bitboard)0xffULL)
+#define BITBOARD_RANK_8 (BITBOARD_RANK_1 << 56)
+
+#define CHESS_SQUARE(File, Rank) ((File) + (Rank) * 8)
+#define CHESS_FILE(Sq) ((Sq) & 7)
+#define CHESS_RANK(Sq) ((Sq) >> 3)
+
+/* Number of set bits.                                                        */
+static inline int BitboardCount(Bitboard Set)
+{
+    return __builtin_popcountll(Set);
+}
+
+/* Lowest set square, Set must not be empty.                                  */
+static inline int BitboardFirst(Bitboard Set)
+{
+    return __builtin_ctzll(Set);
+}
+
+/* Remove and return the lowest set square, *Set must not be empty.           */
+static inline int BitboardPop(Bitboard *Set)
+{
+    int Sq = __builtin_ctzll(*Set);
+
+    *Set &= *Set - 1;
+    return Sq;
+}
+
+/* True if more than one bit is set.                                          */
+static inline int BitboardMany(Bitboard Set)
+{
+    return (Set & (Set - 1)) != 0;
+}
+
+#endif /* BITBOARD_H */
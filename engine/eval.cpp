@@ -0,0 +1,95 @@
+#include "eval.h"
+#include "moves.h"
+
+/* Piece-square bonuses in centipawns, laid out as seen from white with the   */
+/* eighth rank on top. White looks a square up with Sq ^ 56, black with Sq.   */
+static const short PieceSquares[CHESS_PIECE_TYPES][64] = {
+    /* King, keep it behind its pawns.                                        */
+    {
+        -30, -40, -40, -50, -50, -40, -40, -30,
+        -30, -40, -40, -50, -50, -40, -40, -30,
+        -30, -40, -40, -50, -50, -40, -40, -30,
+        -30, -40, -40, -50, -50, -40, -40, -30,
+        -20, -30, -30, -40, -40, -30, -30, -20,
+        -10, -20, -20, -20, -20, -20, -20, -10,
+         20,  20,   0,   0,   0,   0,  20,  20,
+         20,  30,  10,   0,   0,  10,  30,  20,
+    },
+    /* Queen.                                                                 */
+    {
+        -20, -10, -10,  -5,  -5, -10, -10, -20,
+        -10,   0,   0,   0,   0,   0,   0, -10,
+        -10,   0,   5,   5,   5,   5,   0, -10,
+         -5,   0,   5,   5,   5,   5,   0,  -5,
+          0,   0,   5,   5,   5,   5,   0,  -5,
+        -10,   5,   5,   5,   5,   5,   0, -10,
+        -10,   0,   5,   0,   0,   0,   0, -10,
+        -20, -10, -10,  -5,  -5, -10, -10, -20,
+    },
+    /* Rook, the seventh rank and the centre files.                           */
+    {
+          0,   0,   0,   0,   0,   0,   0,   0,
+          5,  10,  10,  10,  10,  10,  10,   5,
+         -5,   0,   0,   0,   0,   0,   0,  -5,
+         -5,   0,   0,   0,   0,   0,   0,  -5,
+         -5,   0,   0,   0,   0,   0,   0,  -5,
+         -5,   0,   0,   0,   0,   0,   0,  -5,
+         -5,   0,   0,   0,   0,   0,   0,  -5,
+          0,   0,   0,   5,   5,   0,   0,   0,
+    },
+    /* Knight, a knight on the rim is dim.                                    */
+    {
+        -50, -40, -30, -30, -30, -30, -40, -50,
+        -40, -20,   0,   0,   0,   0, -20, -40,
+        -30,   0,  10,  15,  15,  10,   0, -30,
+        -30,   5,  15,  20,  20,  15,   5, -30,
+        -30,   0,  15,  20,  20,  15,   0, -30,
+        -30,   5,  10,  15,  15,  10,   5, -30,
+        -40, -20,   0,   5,   5,   0, -20, -40,
+        -50, -40, -30, -30, -30, -30, -40, -50,
+    },
+    /* Bishop, long diagonals.                                                */
+    {
+        -20, -10, -10, -10, -10, -10, -10, -20,
+        -10,   0,   0,   0,   0,   0,   0, -10,
+        -10,   0,   5,  10,  10,   5,   0, -10,
+        -10,   5,   5,  10,  10,   5,   5, -10,
+        -10,   0,  10,  10,  10,  10,   0, -10,
+        -10,  10,  10,  10,  10,  10,  10, -10,
+        -10,   5,   0,   0,   0,   0,   5, -10,
+        -20, -10, -10, -10, -10, -10, -10, -20,
+    },
+    /* Pawn, push the centre and keep the king's cover.                       */
+    {
+          0,   0,   0,   0,   0,   0,   0,   0,
+         50,  50,  50,  50,  50,  50,  50,  50,
+         10,  10,  20,  30,  30,  20,  10,  10,
+          5,   5,  10,  25,  25,  10,   5,   5,
+          0,   0,   0,  20,  20,   0,   0,   0,
+          5,  -5, -10,   0,   0, -10,  -5,   5,
+          5,  10,  10, -20, -20,  10,  10,   5,
+          0,   0,   0,   0,   0,   0,   0,   0,
+    },
+};
+
+int EvalPosition(const ChessPosition *Pos)
+{
+    int Score[2] = {0, 0};
+    Bitboard Set;
+
+    for (int Type = 0; Type < CHESS_PIECE_TYPES; Type++) {
+        Set = Pos -> Pieces[CHESS_WHITE][Type];
+        while (Set) {
+            Score[CHESS_WHITE] += MovesValues[Type] +
+                                  PieceSquares[Type][BitboardPop(&Set) ^ 56];
+        }
+
+        Set = Pos -> Pieces[CHESS_BLACK][Type];
+        while (Set) {
+            Score[CHESS_BLACK] += MovesValues[Type] +
+                                  PieceSquares[Type][BitboardPop(&Set)];
+        }
+    }
+
+    return Score[Pos -> SideToMove] - Score[Pos -> SideToMove ^ 1];
+}
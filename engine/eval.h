@@ -0,0 +1,37 @@
+/******************************************************************************\
+*  eval.h                                                                      *
+*                                                                              *
+*  Static evaluation, material plus piece-square tables, scored in             *
+*  centipawns from the side to move's point of view.                           *
+*                                                                              *
+*              Written by Abed Na'ran                          October 2026    *
+*                                                                              *
+\******************************************************************************/
+#ifndef EVAL_H
+#define EVAL_H
+#include "position.h"
+
+/* Bounds every score, mates are scored EVAL_MATE minus the plies to mate.    */
+#define EVAL_INFINITE (32000)
+#define EVAL_MATE (31000)
+
+/* Scores past this are mates.                                                */
+#define EVAL_MATE_BOUND (EVAL_MATE - 1000)
+
+/******************************************************************************\
+* EvalPosition                                                                 *
+*                                                                              *
+*  Evaluate a position without searching it.                                   *
+*                                                                              *
+* Parameters                                                                   *
+*                                                                              *
+*  -Pos: The position.                                                         *
+*                                                                              *
+* Return                                                                       *
+*                                                                              *
+*  -int: The score for the side to move, positive when it's ahead.             *
+*                                                                              *
+\******************************************************************************/
+int EvalPosition(const ChessPosition *Pos);
+
+#endif /* EVAL_H */
@@ -0,0 +1,131 @@
+/******************************************************************************\
+*  move.h                                                                      *
+*                                                                              *
+*  The engine's move encoding. A move packs its source square in bits 0-5,     *
+*  its destination in bits 6-11, CHESS_MOVE_* flags in bits 12-15 and an       *
+*  ordering key in bits 16-31, so sorting moves sorts them by key.             *
+*                                                                              *
+*              Written by Abed Na'ran                          October 2026    *
+*                                                                              *
+\******************************************************************************/
+#ifndef MOVE_H
+#define MOVE_H
+#include "bitboard.h"
+
+typedef unsigned ChessMove;
+
+/* The low two bits of a promotion pick the piece, queen first.               */
+enum {
+    CHESS_MOVE_QUIET = 0x0,
+    CHESS_MOVE_DOUBLE_PUSH = 0x1,
+    CHESS_MOVE_CASTLE_KING = 0x2,
+    CHESS_MOVE_CASTLE_QUEEN = 0x3,
+    CHESS_MOVE_CAPTURE = 0x4,
+    CHESS_MOVE_EN_PASSANT = 0x5,
+    CHESS_MOVE_PROMOTION = 0x8,
+};
+
+/* Room for a move in long algebraic notation, e7e8q and its terminator.      */
+#define CHESS_MOVE_TEXT (6)
+
+/* The most moves any legal position has is 218.                              */
+#define CHESS_MAX_MOVES (256)
+
+/* Source and destination can't match, so this is never a move.               */
+#define CHESS_NO_MOVE ((ChessMove)0)
+
+/* Keys are stored offset so an unsigned compare orders them as signed, a     */
+/* freshly generated move has the lowest key.                                 */
+#define CHESS_MOVE_KEY_BIAS (0x8000)
+
+typedef struct MoveList {
+    ChessMove Moves[CHESS_MAX_MOVES];
+    int Count;
+} MoveList;
+
+constexpr ChessMove MoveCreate(int From, int To, int Flags)
+{
+    return (ChessMove)(From | (To << 6) | (Flags << 12));
+}
+
+constexpr int MoveFrom(ChessMove Move)
+{
+    return Move & 0x3f;
+}
+
+constexpr int MoveTo(ChessMove Move)
+{
+    return (Move >> 6) & 0x3f;
+}
+
+constexpr int MoveFlags(ChessMove Move)
+{
+    return (Move >> 12) & 0x0f;
+}
+
+constexpr int MoveIsCapture(ChessMove Move)
+{
+    return (MoveFlags(Move) & CHESS_MOVE_CAPTURE) != 0;
+}
+
+constexpr int MoveIsPromotion(ChessMove Move)
+{
+    return (MoveFlags(Move) & CHESS_MOVE_PROMOTION) != 0;
+}
+
+/* Queen, rook, knight and bishop follow each other in the piece types.       */
+constexpr int MovePromotionType(ChessMove Move)
+{
+    return (MoveFlags(Move) & 0x03) + 1;
+}
+
+/* The move without its ordering key, what to compare moves by.               */
+constexpr ChessMove MoveBase(ChessMove Move)
+{
+    return Move & 0xffff;
+}
+
+constexpr int MoveKey(ChessMove Move)
+{
+    return (int)(Move >> 16) - CHESS_MOVE_KEY_BIAS;
+}
+
+/* Key must fit in a signed 16-bit value.                                     */
+constexpr ChessMove MoveWithKey(ChessMove Move, int Key)
+{
+    return MoveBase(Move) | ((ChessMove)(Key + CHESS_MOVE_KEY_BIAS) << 16);
+}
+
+/* Write Move in long algebraic notation, e2e4 or e7e8q, into Out, which      */
+/* holds CHESS_MOVE_TEXT characters.                                          */
+static inline void MoveWrite(ChessMove Move, char *Out)
+{
+    static const char Promotions[] = "qrnb";
+
+    Out[0] = 'a' + CHESS_FILE(MoveFrom(Move));
+    Out[1] = '1' + CHESS_RANK(MoveFrom(Move));
+    Out[2] = 'a' + CHESS_FILE(MoveTo(Move));
+    Out[3] = '1' + CHESS_RANK(MoveTo(Move));
+    Out[4] = MoveIsPromotion(Move) ? Promotions[MoveFlags(Move) & 0x03] : '\0';
+    Out[5] = '\0';
+}
+
+/* Swap the highest keyed move of List from Start on into Start and return    */
+/* it, a selection sort step so only the moves actually tried get sorted.     */
+static inline ChessMove MoveListPick(MoveList *List, int Start)
+{
+    int Best = Start;
+    ChessMove Move;
+
+    for (int i = Start + 1; i < List -> Count; i++) {
+        if (List -> Moves[i] > List -> Moves[Best])
+            Best = i;
+    }
+
+    Move = List -> Moves[Best];
+    List -> Moves[Best] = List -> Moves[Start];
+    List -> Moves[Start] = Move;
+    return Move;
+}
+
+#endif /* MOVE_H */
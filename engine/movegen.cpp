@@ -0,0 +1,307 @@
+#include "movegen.h"
+#include "attacks.h"
+
+static inline int AddPromotions(ChessMove *Moves, int From, int To, int Flags);
+static inline int AddTargets(ChessMove *Moves,
+                             int From,
+                             Bitboard Targets,
+                             Bitboard Theirs);
+static inline EMBERS_BOOL EnPassantLegal(const ChessPosition *Pos,
+                                         int From,
+                                         int King,
+                                         Bitboard Checkers);
+static int Generate(const ChessPosition *Pos,
+                    Bitboard Pieces,
+                    int Kind,
+                    ChessMove *Moves);
+
+int AddPromotions(ChessMove *Moves, int From, int To, int Flags)
+{
+    for (int i = 0; i < 4; i++)
+        Moves[i] = MoveCreate(From, To, Flags | CHESS_MOVE_PROMOTION | i);
+
+    return 4;
+}
+
+int AddTargets(ChessMove *Moves, int From, Bitboard Targets, Bitboard Theirs)
+{
+    int Count = 0, To;
+
+    while (Targets) {
+        To = BitboardPop(&Targets);
+        Moves[Count++] = MoveCreate(From,
+                                    To,
+                                    BITBOARD_SQUARE(To) & Theirs ?
+                                    CHESS_MOVE_CAPTURE : CHESS_MOVE_QUIET);
+    }
+
+    return Count;
+}
+
+/* En passant removes two pieces from the capturing rank, which can uncover   */
+/* a slider that the pin mask doesn't see, so it's checked directly.          */
+EMBERS_BOOL EnPassantLegal(const ChessPosition *Pos,
+                           int From,
+                           int King,
+                           Bitboard Checkers)
+{
+    int Them = Pos -> SideToMove ^ 1,
+        Captured = Pos -> EnPassant + (Them == CHESS_WHITE ? 8 : -8);
+    const Bitboard *Theirs = Pos -> Pieces[Them];
+    Bitboard Occ = Pos -> Occupancy[CHESS_BOTH] ^
+                   BITBOARD_SQUARE(From) ^
+                   BITBOARD_SQUARE(Captured) ^
+                   BITBOARD_SQUARE(Pos -> EnPassant);
+
+    /* A knight or pawn check is only answered by taking the checker.         */
+    if (Checkers & ~BITBOARD_SQUARE(Captured) &
+            (Theirs[CHESS_KNIGHT] | Theirs[CHESS_PAWN]))
+        return EMBERS_FALSE;
+
+    if (AttacksRook(King, Occ) & (Theirs[CHESS_ROOK] | Theirs[CHESS_QUEEN]))
+        return EMBERS_FALSE;
+
+    return !(AttacksBishop(King, Occ) &
+             (Theirs[CHESS_BISHOP] | Theirs[CHESS_QUEEN]));
+}
+
+/* Only the moves of the pieces in Pieces are generated, the checkers and     */
+/* pins are worked out for the whole side either way. Kind picks captures,    */
+/* quiets or both, promotions count as captures.                              */
+int Generate(const ChessPosition *Pos,
+             Bitboard Pieces,
+             int Kind,
+             ChessMove *Moves)
+{
+    int Us = Pos -> SideToMove,
+        Them = Us ^ 1,
+        Up = Us == CHESS_WHITE ? 8 : -8,
+        King = BitboardFirst(Pos -> Pieces[Us][CHESS_KING]),
+        Count = 0,
+        From, To;
+    const Bitboard *Theirs = Pos -> Pieces[Them];
+    Bitboard Occ = Pos -> Occupancy[CHESS_BOTH],
+             Own = Pos -> Occupancy[Us],
+             Enemy = Pos -> Occupancy[Them],
+             Checkers = MoveGenAttackersTo(Pos, King, Occ) & Enemy,
+             CheckMask = BITBOARD_FULL,
+             Pinned = 0,
+             Wanted = (Kind & MOVEGEN_CAPTURES ? Enemy : 0) |
+                      (Kind & MOVEGEN_QUIETS ? ~Occ : 0),
+             Snipers, Blockers, Targets, Allowed, Set;
+
+    /* The king may not step onto an attacked square, nor stay on a checking  */
+    /* slider's ray, hence the lookup without the king on the board.          */
+    Targets = (Pieces & BITBOARD_SQUARE(King)) ? AttacksKing[King] & Wanted : 0;
+    while (Targets) {
+        To = BitboardPop(&Targets);
+        if (MoveGenAttackersTo(Pos, To, Occ ^ BITBOARD_SQUARE(King)) & Enemy)
+            continue;
+
+        Moves[Count++] = MoveCreate(King,
+                                    To,
+                                    BITBOARD_SQUARE(To) & Enemy ?
+                                    CHESS_MOVE_CAPTURE : CHESS_MOVE_QUIET);
+    }
+
+    /* Only the king can answer a double check.                               */
+    if (BitboardMany(Checkers))
+        return Count;
+
+    if (Checkers)
+        CheckMask = AttacksBetween[King][BitboardFirst(Checkers)] | Checkers;
+
+    Snipers = (AttacksRook(King, Enemy) &
+               (Theirs[CHESS_ROOK] | Theirs[CHESS_QUEEN])) |
+              (AttacksBishop(King, Enemy) &
+               (Theirs[CHESS_BISHOP] | Theirs[CHESS_QUEEN]));
+
+    while (Snipers) {
+        Blockers = AttacksBetween[King][BitboardPop(&Snipers)] & Occ;
+        if (Blockers && !BitboardMany(Blockers) && (Blockers & Own))
+            Pinned |= Blockers;
+    }
+
+    /* A pinned knight can never stay on its pin line.                        */
+    Set = Pos -> Pieces[Us][CHESS_KNIGHT] & Pieces & ~Pinned;
+    while (Set) {
+        From = BitboardPop(&Set);
+        Count += AddTargets(Moves + Count,
+                            From,
+                            AttacksKnight[From] & Wanted & CheckMask,
+                            Enemy);
+    }
+
+    Set = (Pos -> Pieces[Us][CHESS_BISHOP] | Pos -> Pieces[Us][CHESS_QUEEN]) &
+          Pieces;
+    while (Set) {
+        From = BitboardPop(&Set);
+        Allowed = CheckMask;
+        if (Pinned & BITBOARD_SQUARE(From))
+            Allowed &= AttacksLine[King][From];
+
+        Count += AddTargets(Moves + Count,
+                            From,
+                            AttacksBishop(From, Occ) & Wanted & Allowed,
+                            Enemy);
+    }
+
+    Set = (Pos -> Pieces[Us][CHESS_ROOK] | Pos -> Pieces[Us][CHESS_QUEEN]) &
+          Pieces;
+    while (Set) {
+        From = BitboardPop(&Set);
+        Allowed = CheckMask;
+        if (Pinned & BITBOARD_SQUARE(From))
+            Allowed &= AttacksLine[King][From];
+
+        Count += AddTargets(Moves + Count,
+                            From,
+                            AttacksRook(From, Occ) & Wanted & Allowed,
+                            Enemy);
+    }
+
+    Set = Pos -> Pieces[Us][CHESS_PAWN] & Pieces;
+    while (Set) {
+        Bitboard LastRank = Us == CHESS_WHITE ? BITBOARD_RANK_8 :
+                                                BITBOARD_RANK_1;
+        int StartRank = Us == CHESS_WHITE ? 1 : 6;
+
+        From = BitboardPop(&Set);
+        Allowed = CheckMask;
+        if (Pinned & BITBOARD_SQUARE(From))
+            Allowed &= AttacksLine[King][From];
+
+        To = From + Up;
+        if (!(Occ & BITBOARD_SQUARE(To))) {
+            if (Allowed & BITBOARD_SQUARE(To)) {
+                if (LastRank & BITBOARD_SQUARE(To)) {
+                    if (Kind & MOVEGEN_CAPTURES)
+                        Count += AddPromotions(Moves + Count,
+                                               From,
+                                               To,
+                                               CHESS_MOVE_QUIET);
+                } else if (Kind & MOVEGEN_QUIETS) {
+                    Moves[Count++] = MoveCreate(From, To, CHESS_MOVE_QUIET);
+                }
+            }
+
+            if ((Kind & MOVEGEN_QUIETS) &&
+                    CHESS_RANK(From) == StartRank &&
+                    !(Occ & BITBOARD_SQUARE(To + Up)) &&
+                    (Allowed & BITBOARD_SQUARE(To + Up)))
+                Moves[Count++] = MoveCreate(From,
+                                            To + Up,
+                                            CHESS_MOVE_DOUBLE_PUSH);
+        }
+
+        if (!(Kind & MOVEGEN_CAPTURES))
+            continue;
+
+        Targets = AttacksPawn[Us][From] & Enemy & Allowed;
+        while (Targets) {
+            To = BitboardPop(&Targets);
+            if (LastRank & BITBOARD_SQUARE(To))
+                Count += AddPromotions(Moves + Count,
+                                       From,
+                                       To,
+                                       CHESS_MOVE_CAPTURE);
+            else
+                Moves[Count++] = MoveCreate(From, To, CHESS_MOVE_CAPTURE);
+        }
+
+        if (Pos -> EnPassant != CHESS_NO_SQUARE &&
+                (AttacksPawn[Us][From] & BITBOARD_SQUARE(Pos -> EnPassant)) &&
+                EnPassantLegal(Pos, From, King, Checkers))
+            Moves[Count++] = MoveCreate(From,
+                                        Pos -> EnPassant,
+                                        CHESS_MOVE_EN_PASSANT);
+    }
+
+    if (Checkers || !(Kind & MOVEGEN_QUIETS) ||
+            !(Pieces & BITBOARD_SQUARE(King)))
+        return Count;
+
+    /* Castling, the king's path must be empty and unattacked. The rights     */
+    /* guarantee the king and rook are still home.                            */
+    if (Pos -> Castling & (Us == CHESS_WHITE ? CHESS_CASTLE_WHITE_KING :
+                                               CHESS_CASTLE_BLACK_KING) &&
+            !(Occ & (BITBOARD_SQUARE(King + 1) | BITBOARD_SQUARE(King + 2))) &&
+            !(MoveGenAttackersTo(Pos, King + 1, Occ) & Enemy) &&
+            !(MoveGenAttackersTo(Pos, King + 2, Occ) & Enemy))
+        Moves[Count++] = MoveCreate(King, King + 2, CHESS_MOVE_CASTLE_KING);
+
+    if (Pos -> Castling & (Us == CHESS_WHITE ? CHESS_CASTLE_WHITE_QUEEN :
+                                               CHESS_CASTLE_BLACK_QUEEN) &&
+            !(Occ & (BITBOARD_SQUARE(King - 1) |
+                     BITBOARD_SQUARE(King - 2) |
+                     BITBOARD_SQUARE(King - 3))) &&
+            !(MoveGenAttackersTo(Pos, King - 1, Occ) & Enemy) &&
+            !(MoveGenAttackersTo(Pos, King - 2, Occ) & Enemy))
+        Moves[Count++] = MoveCreate(King, King - 2, CHESS_MOVE_CASTLE_QUEEN);
+
+    return Count;
+}
+
+int MoveGenLegal(const ChessPosition *Pos, MoveList *List)
+{
+    return List -> Count = Generate(Pos,
+                                    BITBOARD_FULL,
+                                    MOVEGEN_ALL,
+                                    List -> Moves);
+}
+
+int MoveGenFrom(const ChessPosition *Pos, Bitboard Pieces, MoveList *List)
+{
+    return List -> Count = Generate(Pos, Pieces, MOVEGEN_ALL, List -> Moves);
+}
+
+int MoveGenKind(const ChessPosition *Pos, int Kind, MoveList *List)
+{
+    return List -> Count = Generate(Pos, BITBOARD_FULL, Kind, List -> Moves);
+}
+
+EMBERS_BOOL MoveGenIsLegal(const ChessPosition *Pos, ChessMove Move)
+{
+    MoveList List;
+
+    if (Move == CHESS_NO_MOVE)
+        return EMBERS_FALSE;
+
+    List.Count = Generate(Pos,
+                          BITBOARD_SQUARE(MoveFrom(Move)),
+                          MOVEGEN_ALL,
+                          List.Moves);
+    for (int i = 0; i < List.Count; i++) {
+        if (List.Moves[i] == MoveBase(Move))
+            return EMBERS_TRUE;
+    }
+
+    return EMBERS_FALSE;
+}
+
+EMBERS_BOOL MoveGenInCheck(const ChessPosition *Pos)
+{
+    int Us = Pos -> SideToMove,
+        King = BitboardFirst(Pos -> Pieces[Us][CHESS_KING]);
+
+    return (MoveGenAttackersTo(Pos, King, Pos -> Occupancy[CHESS_BOTH]) &
+            Pos -> Occupancy[Us ^ 1]) != 0;
+}
+
+unsigned long long MoveGenPerft(ChessPosition *Pos, int Depth)
+{
+    MoveList List;
+    unsigned long long Nodes = 0;
+
+    if (!Depth)
+        return 1;
+
+    MoveGenLegal(Pos, &List);
+    for (int i = 0; i < List.Count; i++) {
+        PositionMakeMove(Pos, List.Moves[i]);
+        Nodes += MoveGenPerft(Pos, Depth - 1);
+        PositionUnmakeMove(Pos);
+    }
+
+    return Nodes;
+}
@@ -0,0 +1,150 @@
+/******************************************************************************\
+*  movegen.h                                                                   *
+*                                                                              *
+*  Legal move generation. Checkers, pinned pieces and the evasion mask are     *
+*  worked out up front so only legal moves are ever emitted.                   *
+*                                                                              *
+*              Written by Abed Na'ran                          October 2026    *
+*                                                                              *
+\******************************************************************************/
+#ifndef MOVEGEN_H
+#define MOVEGEN_H
+#include "position.h"
+#include "attacks.h"
+
+/* What MoveGenKind generates, promotions are counted as captures.            */
+enum {
+    MOVEGEN_CAPTURES = 0x1,
+    MOVEGEN_QUIETS = 0x2,
+    MOVEGEN_ALL = 0x3
+};
+
+/******************************************************************************\
+* MoveGenLegal                                                                 *
+*                                                                              *
+*  Generate every legal move of the side to move, castling, en passant and     *
+*  promotions included. Promotions are emitted queen first.                    *
+*                                                                              *
+* Parameters                                                                   *
+*                                                                              *
+*  -Pos: The position.                                                         *
+*  -List: The output list, overwritten.                                        *
+*                                                                              *
+* Return                                                                       *
+*                                                                              *
+*  -int: The number of moves generated.                                        *
+*                                                                              *
+\******************************************************************************/
+int MoveGenLegal(const ChessPosition *Pos, MoveList *List);
+
+/******************************************************************************\
+* MoveGenFrom                                                                  *
+*                                                                              *
+*  Generate the legal moves of some of the side to move's pieces only, so      *
+*  one piece's moves cost no more than that piece.                             *
+*                                                                              *
+* Parameters                                                                   *
+*                                                                              *
+*  -Pos: The position.                                                         *
+*  -Pieces: The squares of the pieces to move, others are ignored.             *
+*  -List: The output list, overwritten.                                        *
+*                                                                              *
+* Return                                                                       *
+*                                                                              *
+*  -int: The number of moves generated.                                        *
+*                                                                              *
+\******************************************************************************/
+int MoveGenFrom(const ChessPosition *Pos, Bitboard Pieces, MoveList *List);
+
+/******************************************************************************\
+* MoveGenKind                                                                  *
+*                                                                              *
+*  Generate only the captures or only the quiet moves of the side to move.     *
+*  Captures take in en passant and every promotion, quiets take in castling.   *
+*                                                                              *
+* Parameters                                                                   *
+*                                                                              *
+*  -Pos: The position.                                                         *
+*  -Kind: MOVEGEN_CAPTURES, MOVEGEN_QUIETS or MOVEGEN_ALL.                     *
+*  -List: The output list, overwritten.                                        *
+*                                                                              *
+* Return                                                                       *
+*                                                                              *
+*  -int: The number of moves generated.                                        *
+*                                                                              *
+\******************************************************************************/
+int MoveGenKind(const ChessPosition *Pos, int Kind, MoveList *List);
+
+/******************************************************************************\
+* MoveGenIsLegal                                                               *
+*                                                                              *
+*  Check a move that came from elsewhere, a hash or killer move, against the   *
+*  position. Only the moving piece's moves are generated.                      *
+*                                                                              *
+* Parameters                                                                   *
+*                                                                              *
+*  -Pos: The position.                                                         *
+*  -Move: The move, its ordering key is ignored.                               *
+*                                                                              *
+* Return                                                                       *
+*                                                                              *
+*  -EMBERS_BOOL: EMBERS_TRUE if Move is legal in Pos.                          *
+*                                                                              *
+\******************************************************************************/
+EMBERS_BOOL MoveGenIsLegal(const ChessPosition *Pos, ChessMove Move);
+
+/******************************************************************************\
+* MoveGenInCheck                                                               *
+*                                                                              *
+*  Check whether the side to move's king is attacked.                          *
+*                                                                              *
+* Parameters                                                                   *
+*                                                                              *
+*  -Pos: The position.                                                         *
+*                                                                              *
+* Return                                                                       *
+*                                                                              *
+*  -EMBERS_BOOL: EMBERS_TRUE if the side to move is in check.                  *
+*                                                                              *
+\******************************************************************************/
+EMBERS_BOOL MoveGenInCheck(const ChessPosition *Pos);
+
+/******************************************************************************\
+* MoveGenPerft                                                                 *
+*                                                                              *
+*  Count the leaf nodes of the legal move tree, used to check the generator    *
+*  against known counts. The tree is walked in place with make/unmake.         *
+*                                                                              *
+* Parameters                                                                   *
+*                                                                              *
+*  -Pos: The root position, left as it was found.                              *
+*  -Depth: The depth in plies.                                                 *
+*                                                                              *
+* Return                                                                       *
+*                                                                              *
+*  -unsigned long long: The number of leaf nodes.                              *
+*                                                                              *
+\******************************************************************************/
+unsigned long long MoveGenPerft(ChessPosition *Pos, int Depth);
+
+/* Pieces of both colours that attack Sq, given the occupancy Occ.            */
+static inline Bitboard MoveGenAttackersTo(const ChessPosition *Pos,
+                                          int Sq,
+                                          Bitboard Occ)
+{
+    const Bitboard *White = Pos -> Pieces[CHESS_WHITE],
+                   *Black = Pos -> Pieces[CHESS_BLACK];
+
+    return (AttacksPawn[CHESS_WHITE][Sq] & Black[CHESS_PAWN]) |
+           (AttacksPawn[CHESS_BLACK][Sq] & White[CHESS_PAWN]) |
+           (AttacksKnight[Sq] & (White[CHESS_KNIGHT] | Black[CHESS_KNIGHT])) |
+           (AttacksKing[Sq] & (White[CHESS_KING] | Black[CHESS_KING])) |
+           (AttacksRook(Sq, Occ) & (White[CHESS_ROOK] | Black[CHESS_ROOK] |
+                                    White[CHESS_QUEEN] | Black[CHESS_QUEEN])) |
+           (AttacksBishop(Sq, Occ) & (White[CHESS_BISHOP] |
+                                      Black[CHESS_BISHOP] |
+                                      White[CHESS_QUEEN] |
+                                      Black[CHESS_QUEEN]));
+}
+
+#endif /* MOVEGEN_H */
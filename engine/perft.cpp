@@ -0,0 +1,185 @@
+#include "perft.h"
+#include "movegen.h"
+#include <stdlib.h>
+#include <pthread.h>
+
+/* A root move and optionally one reply, the unit of work handed to threads.  */
+typedef struct PerftTask {
+    int Root; /* Index of the root move.                                      */
+    ChessMove Reply; /* CHESS_NO_MOVE when the root move is the whole task.   */
+} PerftTask;
+
+typedef struct PerftJob {
+    const ChessPosition *Root;
+    PerftTable *Table;
+    const MoveList *Moves;
+    const PerftTask *Tasks;
+    int TaskCount;
+    int Next; /* The next task to take, atomic.                               */
+    int Depth; /* Left to count below a task.                                 */
+    unsigned long long *Counts; /* Added to atomically.                       */
+} PerftJob;
+
+static inline ChessKey DepthKey(ChessKey Key, int Depth);
+static void *Worker(void *Data);
+
+/* The same position at two depths needs two entries.                         */
+ChessKey DepthKey(ChessKey Key, int Depth)
+{
+    return Key ^ (Depth * 0x9e3779b97f4a7c15ULL);
+}
+
+void *Worker(void *Data)
+{
+    PerftJob *Job = (PerftJob*)Data;
+    ChessPosition Pos;
+    const PerftTask *Task;
+    unsigned long long Nodes;
+    int i;
+
+    while ((i = __atomic_fetch_add(&Job -> Next, 1, __ATOMIC_RELAXED)) <
+            Job -> TaskCount) {
+        Task = &Job -> Tasks[i];
+
+        Pos = *Job -> Root;
+        PositionMakeMove(&Pos, Job -> Moves -> Moves[Task -> Root]);
+        if (Task -> Reply != CHESS_NO_MOVE)
+            PositionMakeMove(&Pos, Task -> Reply);
+
+        Nodes = PerftCount(&Pos, Job -> Depth, Job -> Table);
+        __atomic_fetch_add(&Job -> Counts[Task -> Root],
+                           Nodes,
+                           __ATOMIC_RELAXED);
+    }
+
+    return NULL;
+}
+
+EMBERS_BOOL PerftTableCreate(PerftTable *Table, size_t Megabytes)
+{
+    size_t Count = 1;
+
+    while (Count * 2 * sizeof(PerftEntry) <= Megabytes << 20)
+        Count *= 2;
+
+    Table -> Entries = (PerftEntry*)calloc(Count, sizeof(PerftEntry));
+    Table -> Mask = Count - 1;
+    return Table -> Entries != NULL;
+}
+
+void PerftTableFree(PerftTable *Table)
+{
+    free(Table -> Entries);
+    Table -> Entries = NULL;
+}
+
+unsigned long long PerftCount(ChessPosition *Pos, int Depth, PerftTable *Table)
+{
+    MoveList List;
+    PerftEntry *Entry = NULL;
+    unsigned long long Nodes = 0;
+    ChessKey Key = 0;
+
+    if (!Depth)
+        return 1;
+
+    /* The moves at the last ply are counted, never played.                   */
+    if (Depth == 1)
+        return MoveGenLegal(Pos, &List);
+
+    if (Table) {
+        Key = DepthKey(Pos -> Key, Depth);
+        Entry = &Table -> Entries[Key & Table -> Mask];
+
+        Nodes = __atomic_load_n(&Entry -> Nodes, __ATOMIC_RELAXED);
+        if ((__atomic_load_n(&Entry -> Key, __ATOMIC_RELAXED) ^ Nodes) == Key)
+            return Nodes;
+
+        Nodes = 0;
+    }
+
+    MoveGenLegal(Pos, &List);
+    for (int i = 0; i < List.Count; i++) {
+        PositionMakeMove(Pos, List.Moves[i]);
+        Nodes += PerftCount(Pos, Depth - 1, Table);
+        PositionUnmakeMove(Pos);
+    }
+
+    if (Entry) {
+        __atomic_store_n(&Entry -> Key, Key ^ Nodes, __ATOMIC_RELAXED);
+        __atomic_store_n(&Entry -> Nodes, Nodes, __ATOMIC_RELAXED);
+    }
+
+    return Nodes;
+}
+
+unsigned long long PerftDivide(const ChessPosition *Pos,
+                               int Depth,
+                               PerftTable *Table,
+                               int Threads,
+                               MoveList *Moves,
+                               unsigned long long *Counts)
+{
+    ChessPosition Child = *Pos;
+    MoveList Replies;
+    PerftJob Job;
+    PerftTask *Tasks;
+    pthread_t *Handles;
+    unsigned long long Total = 0;
+    int Started = 0;
+
+    MoveGenLegal(Pos, Moves);
+    for (int i = 0; i < Moves -> Count; i++)
+        Counts[i] = 1;
+
+    if (Depth == 1)
+        return Moves -> Count;
+
+    /* A root move only has a few dozen replies, so there's always room.      */
+    Tasks = (PerftTask*)malloc(sizeof(*Tasks) * Moves -> Count *
+                               (Depth > 2 ? CHESS_MAX_MOVES : 1));
+    if (!Tasks)
+        return 0;
+
+    Job.Root = Pos;
+    Job.Table = Table;
+    Job.Moves = Moves;
+    Job.Tasks = Tasks;
+    Job.TaskCount = 0;
+    Job.Next = 0;
+    Job.Depth = Depth > 2 ? Depth - 2 : Depth - 1;
+    Job.Counts = Counts;
+
+    for (int i = 0; i < Moves -> Count; i++) {
+        Counts[i] = 0;
+        if (Depth == 2) {
+            Tasks[Job.TaskCount++] = {i, CHESS_NO_MOVE};
+            continue;
+        }
+
+        PositionMakeMove(&Child, Moves -> Moves[i]);
+        MoveGenLegal(&Child, &Replies);
+        PositionUnmakeMove(&Child);
+
+        for (int j = 0; j < Replies.Count; j++)
+            Tasks[Job.TaskCount++] = {i, Replies.Moves[j]};
+    }
+
+    /* The calling thread works too, and does it all if no thread starts.     */
+    Handles = (pthread_t*)malloc(sizeof(*Handles) * (Threads > 1 ? Threads : 1));
+    for (; Handles && Started < Threads - 1; Started++) {
+        if (pthread_create(&Handles[Started], NULL, Worker, &Job))
+            break;
+    }
+
+    Worker(&Job);
+    for (int i = 0; i < Started; i++)
+        pthread_join(Handles[i], NULL);
+
+    for (int i = 0; i < Moves -> Count; i++)
+        Total += Counts[i];
+
+    free(Handles);
+    free(Tasks);
+    return Total;
+}
@@ -0,0 +1,109 @@
+/******************************************************************************\
+*  perft.h                                                                     *
+*                                                                              *
+*  Fast perft for deep move generator checks. The last ply is counted from     *
+*  the move list without being played, subtree counts are cached by position   *
+*  and depth and the work can be split across threads. The totals match        *
+*  MoveGenPerft exactly.                                                       *
+*                                                                              *
+*              Written by Abed Na'ran                          October 2026    *
+*                                                                              *
+\******************************************************************************/
+#ifndef PERFT_H
+#define PERFT_H
+#include "position.h"
+#include <stddef.h>
+
+/* Threads share the table without locks. Key is stored XORed with Nodes, so  */
+/* an entry torn by two writers fails the key check instead of lying.         */
+typedef struct PerftEntry {
+    ChessKey Key; /* The depth salted position key XOR Nodes.                 */
+    unsigned long long Nodes;
+} PerftEntry;
+
+typedef struct PerftTable {
+    PerftEntry *Entries;
+    size_t Mask; /* Entry count minus one, the count is a power of two.       */
+} PerftTable;
+
+/******************************************************************************\
+* PerftTableCreate                                                             *
+*                                                                              *
+*  Allocate an empty subtree count cache.                                      *
+*                                                                              *
+* Parameters                                                                   *
+*                                                                              *
+*  -Table: The table.                                                          *
+*  -Megabytes: The most memory to use, rounded down to a power of two.         *
+*                                                                              *
+* Return                                                                       *
+*                                                                              *
+*  -EMBERS_BOOL: EMBERS_FALSE if out of memory.                                *
+*                                                                              *
+\******************************************************************************/
+EMBERS_BOOL PerftTableCreate(PerftTable *Table, size_t Megabytes);
+
+/******************************************************************************\
+* PerftTableFree                                                               *
+*                                                                              *
+*  Free a table made by PerftTableCreate.                                      *
+*                                                                              *
+* Parameters                                                                   *
+*                                                                              *
+*  -Table: The table.                                                          *
+*                                                                              *
+* Return                                                                       *
+*                                                                              *
+*  -void.                                                                      *
+*                                                                              *
+\******************************************************************************/
+void PerftTableFree(PerftTable *Table);
+
+/******************************************************************************\
+* PerftCount                                                                   *
+*                                                                              *
+*  Count the leaf nodes of the legal move tree with bulk counting, and with    *
+*  the table if one is given.                                                  *
+*                                                                              *
+* Parameters                                                                   *
+*                                                                              *
+*  -Pos: The root position, left as it was found.                              *
+*  -Depth: The depth in plies.                                                 *
+*  -Table: The subtree count cache or NULL.                                    *
+*                                                                              *
+* Return                                                                       *
+*                                                                              *
+*  -unsigned long long: The number of leaf nodes.                              *
+*                                                                              *
+\******************************************************************************/
+unsigned long long PerftCount(ChessPosition *Pos, int Depth, PerftTable *Table);
+
+/******************************************************************************\
+* PerftDivide                                                                  *
+*                                                                              *
+*  Count the subtree of every root move, split across threads. Below depth 3   *
+*  the root moves are the work items, otherwise every reply to them is one.    *
+*  Threads pull items off a shared counter and all share the table.            *
+*                                                                              *
+* Parameters                                                                   *
+*                                                                              *
+*  -Pos: The root position, not changed.                                       *
+*  -Depth: The depth in plies, at least 1.                                     *
+*  -Table: The subtree count cache or NULL.                                    *
+*  -Threads: The number of threads, including the calling one.                 *
+*  -Moves: Out, the root moves.                                                *
+*  -Counts: Out, the leaf nodes under each root move, CHESS_MAX_MOVES long.    *
+*                                                                              *
+* Return                                                                       *
+*                                                                              *
+*  -unsigned long long: The number of leaf nodes.                              *
+*                                                                              *
+\******************************************************************************/
+unsigned long long PerftDivide(const ChessPosition *Pos,
+                               int Depth,
+                               PerftTable *Table,
+                               int Threads,
+                               MoveList *Moves,
+                               unsigned long long *Counts);
+
+#endif /* PERFT_H */
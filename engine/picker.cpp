@@ -0,0 +1,154 @@
+#include "picker.h"
+#include "movegen.h"
+#include "moves.h"
+
+static inline int CaptureKey(const ChessPosition *Pos, ChessMove Move);
+static inline EMBERS_BOOL IsRefutation(const MovePicker *Picker,
+                                       ChessMove Move);
+
+/* MVV-LVA, the victim decides and the attacker only breaks ties. Victim      */
+/* values are at least 10 apart, which the attacker term can't bridge.        */
+int CaptureKey(const ChessPosition *Pos, ChessMove Move)
+{
+    int Attacker = CHESS_PIECE_TYPE(Pos -> Squares[MoveFrom(Move)]),
+        Victim = Pos -> Squares[MoveTo(Move)],
+        Gain = 0;
+
+    if (MoveFlags(Move) == CHESS_MOVE_EN_PASSANT)
+        Gain = MovesValues[CHESS_PAWN];
+    else if (Victim != CHESS_NO_PIECE)
+        Gain = MovesValues[CHESS_PIECE_TYPE(Victim)];
+
+    if (MoveIsPromotion(Move))
+        Gain += MovesValues[MovePromotionType(Move)] - MovesValues[CHESS_PAWN];
+
+    return Gain * 16 - MovesValues[Attacker] / 8;
+}
+
+EMBERS_BOOL IsRefutation(const MovePicker *Picker, ChessMove Move)
+{
+    for (int i = 0; i < PICKER_REFUTATIONS_COUNT; i++) {
+        if (Picker -> Refutations[i] == Move)
+            return EMBERS_TRUE;
+    }
+
+    return EMBERS_FALSE;
+}
+
+void PickerInit(MovePicker *Picker,
+                const ChessPosition *Pos,
+                ChessMove Hash,
+                const ChessMove *Killers,
+                ChessMove Counter,
+                const int (*History)[64])
+{
+    Picker -> Pos = Pos;
+    Picker -> List.Count = 0;
+    Picker -> Hash = MoveGenIsLegal(Pos, Hash) ? MoveBase(Hash) : CHESS_NO_MOVE;
+    Picker -> Stage = Picker -> Hash != CHESS_NO_MOVE ? PICKER_HASH :
+                                                        PICKER_CAPTURES_INIT;
+    Picker -> Index = 0;
+    Picker -> CapturesOnly = EMBERS_FALSE;
+    Picker -> History = History;
+
+    Picker -> Refutations[0] = Killers ? MoveBase(Killers[0]) : CHESS_NO_MOVE;
+    Picker -> Refutations[1] = Killers ? MoveBase(Killers[1]) : CHESS_NO_MOVE;
+    Picker -> Refutations[2] = MoveBase(Counter);
+}
+
+void PickerInitCaptures(MovePicker *Picker, const ChessPosition *Pos)
+{
+    PickerInit(Picker, Pos, CHESS_NO_MOVE, NULL, CHESS_NO_MOVE, NULL);
+    Picker -> CapturesOnly = EMBERS_TRUE;
+}
+
+ChessMove PickerNext(MovePicker *Picker)
+{
+    ChessMove Move;
+
+    switch (Picker -> Stage) {
+    case PICKER_HASH:
+        Picker -> Stage = PICKER_CAPTURES_INIT;
+        return Picker -> Hash;
+
+    case PICKER_CAPTURES_INIT:
+        MoveGenKind(Picker -> Pos, MOVEGEN_CAPTURES, &Picker -> List);
+        for (int i = 0; i < Picker -> List.Count; i++) {
+            Move = Picker -> List.Moves[i];
+            Picker -> List.Moves[i] =
+                MoveWithKey(Move, CaptureKey(Picker -> Pos, Move));
+        }
+
+        Picker -> Index = 0;
+        Picker -> Stage = PICKER_CAPTURES;
+        /* Fall through.                                                      */
+
+    case PICKER_CAPTURES:
+        while (Picker -> Index < Picker -> List.Count) {
+            Move = MoveBase(MoveListPick(&Picker -> List, Picker -> Index++));
+            if (Move != Picker -> Hash)
+                return Move;
+        }
+
+        Picker -> Index = 0;
+        Picker -> Stage = Picker -> CapturesOnly ? PICKER_DONE :
+                                                   PICKER_REFUTATIONS;
+        if (Picker -> CapturesOnly)
+            return CHESS_NO_MOVE;
+
+        /* Fall through.                                                      */
+
+    case PICKER_REFUTATIONS:
+        while (Picker -> Index < PICKER_REFUTATIONS_COUNT) {
+            int i = Picker -> Index++;
+
+            Move = Picker -> Refutations[i];
+
+            /* Captures were all picked already, and a move may be both a     */
+            /* killer and the counter move.                                   */
+            if (Move == CHESS_NO_MOVE || Move == Picker -> Hash ||
+                    MoveIsCapture(Move) || MoveIsPromotion(Move))
+                continue;
+
+            if ((i > 0 && Move == Picker -> Refutations[0]) ||
+                    (i > 1 && Move == Picker -> Refutations[1]))
+                continue;
+
+            if (MoveGenIsLegal(Picker -> Pos, Move))
+                return Move;
+        }
+
+        Picker -> Stage = PICKER_QUIETS_INIT;
+        /* Fall through.                                                      */
+
+    case PICKER_QUIETS_INIT:
+        MoveGenKind(Picker -> Pos, MOVEGEN_QUIETS, &Picker -> List);
+        for (int i = 0; Picker -> History && i < Picker -> List.Count; i++) {
+            Move = Picker -> List.Moves[i];
+            Picker -> List.Moves[i] =
+                MoveWithKey(Move,
+                            Picker -> History[MoveFrom(Move)][MoveTo(Move)]);
+        }
+
+        Picker -> Index = 0;
+        Picker -> Stage = PICKER_QUIETS;
+        /* Fall through.                                                      */
+
+    case PICKER_QUIETS:
+        while (Picker -> Index < Picker -> List.Count) {
+            Move = Picker -> History ?
+                   MoveListPick(&Picker -> List, Picker -> Index) :
+                   Picker -> List.Moves[Picker -> Index];
+            Move = MoveBase(Move);
+            Picker -> Index++;
+            if (Move != Picker -> Hash && !IsRefutation(Picker, Move))
+                return Move;
+        }
+
+        Picker -> Stage = PICKER_DONE;
+        /* Fall through.                                                      */
+
+    default:
+        return CHESS_NO_MOVE;
+    }
+}
@@ -0,0 +1,101 @@
+/******************************************************************************\
+*  picker.h                                                                    *
+*                                                                              *
+*  The staged move picker. Moves come out a stage at a time, the hash move,    *
+*  captures by MVV-LVA, killers and the counter move, then quiet moves by      *
+*  history, and each stage is only generated once the one before it runs dry.  *
+*                                                                              *
+*              Written by Abed Na'ran                          October 2026    *
+*                                                                              *
+\******************************************************************************/
+#ifndef PICKER_H
+#define PICKER_H
+#include "position.h"
+
+enum {
+    PICKER_HASH = 0,
+    PICKER_CAPTURES_INIT,
+    PICKER_CAPTURES,
+    PICKER_REFUTATIONS,
+    PICKER_QUIETS_INIT,
+    PICKER_QUIETS,
+    PICKER_DONE
+};
+
+/* Two killers followed by the counter move.                                  */
+#define PICKER_REFUTATIONS_COUNT (3)
+
+typedef struct MovePicker {
+    const ChessPosition *Pos;
+    MoveList List; /* The stage being picked from.                            */
+    ChessMove Hash;
+    ChessMove Refutations[PICKER_REFUTATIONS_COUNT];
+    const int (*History)[64]; /* Quiet move scores by from and to, or NULL.   */
+    int Stage;
+    int Index; /* The next move of List, or refutation.                       */
+    EMBERS_BOOL CapturesOnly; /* Stop once the captures are picked.           */
+} MovePicker;
+
+/******************************************************************************\
+* PickerInit                                                                   *
+*                                                                              *
+*  Start picking the moves of a position. Nothing is generated yet.            *
+*                                                                              *
+* Parameters                                                                   *
+*                                                                              *
+*  -Picker: The picker.                                                        *
+*  -Pos: The position, must not change while the picker is in use.             *
+*  -Hash: The move to try first or CHESS_NO_MOVE, checked for legality.        *
+*  -Killers: Two quiet moves that cut off at this ply before, or NULL.         *
+*  -Counter: The quiet reply to the previous move or CHESS_NO_MOVE.            *
+*  -History: The side to move's quiet move scores by from and to square, each  *
+*  fitting 16 bits, or NULL to leave quiets in generation order.               *
+*                                                                              *
+* Return                                                                       *
+*                                                                              *
+*  -void.                                                                      *
+*                                                                              *
+\******************************************************************************/
+void PickerInit(MovePicker *Picker,
+                const ChessPosition *Pos,
+                ChessMove Hash,
+                const ChessMove *Killers,
+                ChessMove Counter,
+                const int (*History)[64]);
+
+/******************************************************************************\
+* PickerInitCaptures                                                           *
+*                                                                              *
+*  Start picking only the captures and promotions of a position, by MVV-LVA,   *
+*  for the quiescence search.                                                  *
+*                                                                              *
+* Parameters                                                                   *
+*                                                                              *
+*  -Picker: The picker.                                                        *
+*  -Pos: The position, must not change while the picker is in use.             *
+*                                                                              *
+* Return                                                                       *
+*                                                                              *
+*  -void.                                                                      *
+*                                                                              *
+\******************************************************************************/
+void PickerInitCaptures(MovePicker *Picker, const ChessPosition *Pos);
+
+/******************************************************************************\
+* PickerNext                                                                   *
+*                                                                              *
+*  Pick the next move, generating the next stage when the current one is       *
+*  done. Every legal move the picker covers is picked exactly once.            *
+*                                                                              *
+* Parameters                                                                   *
+*                                                                              *
+*  -Picker: The picker.                                                        *
+*                                                                              *
+* Return                                                                       *
+*                                                                              *
+*  -ChessMove: The move without its key, CHESS_NO_MOVE once all are picked.    *
+*                                                                              *
+\******************************************************************************/
+ChessMove PickerNext(MovePicker *Picker);
+
+#endif /* PICKER_H */
@@ -0,0 +1,358 @@
+#include "position.h"
+#include <string.h>
+#include <ctype.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+static constexpr ChessKey SplitMix(ChessKey *State);
+static constexpr ChessZobrist BuildZobrist();
+static inline ChessKey EnPassantKey(int Sq);
+static inline void VerifyKey(const ChessPosition *Pos);
+
+/* SplitMix64, good enough to spread the keys and simple enough to constexpr. */
+constexpr ChessKey SplitMix(ChessKey *State)
+{
+    ChessKey Key = (*State += 0x9e3779b97f4a7c15ULL);
+
+    Key = (Key ^ (Key >> 30)) * 0xbf58476d1ce4e5b9ULL;
+    Key = (Key ^ (Key >> 27)) * 0x94d049bb133111ebULL;
+    return Key ^ (Key >> 31);
+}
+
+constexpr ChessZobrist BuildZobrist()
+{
+    ChessZobrist Zobrist = {};
+    ChessKey State = 0x454d42455253ULL;
+
+    for (int Colour = 0; Colour < 2; Colour++) {
+        for (int Type = 0; Type < CHESS_PIECE_TYPES; Type++) {
+            for (int Sq = 0; Sq < 64; Sq++)
+                Zobrist.Pieces[Colour][Type][Sq] = SplitMix(&State);
+        }
+    }
+
+    for (int i = 0; i < 16; i++)
+        Zobrist.Castling[i] = SplitMix(&State);
+
+    for (int i = 0; i < 8; i++)
+        Zobrist.EnPassant[i] = SplitMix(&State);
+
+    Zobrist.Side = SplitMix(&State);
+    return Zobrist;
+}
+
+constexpr ChessZobrist PositionZobrist = BuildZobrist();
+
+ChessKey EnPassantKey(int Sq)
+{
+    return Sq != CHESS_NO_SQUARE ? PositionZobrist.EnPassant[CHESS_FILE(Sq)] : 0;
+}
+
+/* A key that drifts from the position poisons every table it's stored in,    */
+/* debug builds recompute it after every move and stop at the first mismatch. */
+void VerifyKey(const ChessPosition *Pos)
+{
+#ifdef EMBERS_DEBUG
+    if (Pos -> Key != PositionKey(Pos)) {
+        EMBERS_LOG_ERROR("Incremental position key doesn't match.");
+        abort();
+    }
+#else
+    (void)Pos;
+#endif
+}
+
+void PositionClear(ChessPosition *Pos)
+{
+    memset(Pos -> Pieces, 0, sizeof(Pos -> Pieces));
+    memset(Pos -> Occupancy, 0, sizeof(Pos -> Occupancy));
+    memset(Pos -> Squares, CHESS_NO_PIECE, sizeof(Pos -> Squares));
+
+    Pos -> SideToMove = CHESS_WHITE;
+    Pos -> Castling = 0;
+    Pos -> EnPassant = CHESS_NO_SQUARE;
+    Pos -> HalfmoveClock = 0;
+    Pos -> FullmoveNumber = 1;
+    Pos -> HistoryLength = 0;
+    Pos -> Key = PositionKey(Pos);
+}
+
+void PositionInferCastling(ChessPosition *Pos)
+{
+    static const struct {
+        int Right, King, Rook, Colour;
+    } Rights[4] = {
+        {CHESS_CASTLE_WHITE_KING, 4, 7, CHESS_WHITE},
+        {CHESS_CASTLE_WHITE_QUEEN, 4, 0, CHESS_WHITE},
+        {CHESS_CASTLE_BLACK_KING, 60, 63, CHESS_BLACK},
+        {CHESS_CASTLE_BLACK_QUEEN, 60, 56, CHESS_BLACK},
+    };
+    int Old = Pos -> Castling;
+
+    Pos -> Castling = 0;
+    for (int i = 0; i < 4; i++) {
+        if (Pos -> Squares[Rights[i].King] !=
+                CHESS_PIECE(Rights[i].Colour, CHESS_KING))
+            continue;
+
+        if (Pos -> Squares[Rights[i].Rook] !=
+                CHESS_PIECE(Rights[i].Colour, CHESS_ROOK))
+            continue;
+
+        Pos -> Castling |= Rights[i].Right;
+    }
+
+    Pos -> Key ^= PositionZobrist.Castling[Old] ^
+                  PositionZobrist.Castling[Pos -> Castling];
+}
+
+EMBERS_BOOL PositionFromFEN(ChessPosition *Pos, const char *FEN)
+{
+    static const char Pieces[] = "kqrnbp";
+    const char *Type;
+    int File = 0, Rank = 7;
+
+    PositionClear(Pos);
+
+    for (; *FEN && *FEN != ' '; FEN++) {
+        if (*FEN == '/') {
+            if (File != 8 || !Rank)
+                return EMBERS_FALSE;
+
+            File = 0;
+            Rank--;
+        } else if (*FEN >= '1' && *FEN <= '8') {
+            File += *FEN - '0';
+        } else if ((Type = strchr(Pieces, tolower(*FEN))) && File < 8) {
+            PositionSetPiece(Pos,
+                             CHESS_SQUARE(File, Rank),
+                             CHESS_PIECE(islower(*FEN) ? CHESS_BLACK :
+                                                         CHESS_WHITE,
+                                         Type - Pieces));
+            File++;
+        } else {
+            return EMBERS_FALSE;
+        }
+    }
+
+    if (File != 8 || Rank || *FEN++ != ' ')
+        return EMBERS_FALSE;
+
+    if (*FEN != 'w' && *FEN != 'b')
+        return EMBERS_FALSE;
+
+    Pos -> SideToMove = *FEN++ == 'w' ? CHESS_WHITE : CHESS_BLACK;
+    if (*FEN++ != ' ')
+        return EMBERS_FALSE;
+
+    for (; *FEN && *FEN != ' '; FEN++) {
+        switch (*FEN) {
+            case 'K': Pos -> Castling |= CHESS_CASTLE_WHITE_KING; break;
+            case 'Q': Pos -> Castling |= CHESS_CASTLE_WHITE_QUEEN; break;
+            case 'k': Pos -> Castling |= CHESS_CASTLE_BLACK_KING; break;
+            case 'q': Pos -> Castling |= CHESS_CASTLE_BLACK_QUEEN; break;
+            case '-': break;
+            default: return EMBERS_FALSE;
+        }
+    }
+
+    if (*FEN++ != ' ')
+        return EMBERS_FALSE;
+
+    if (*FEN >= 'a' && *FEN <= 'h' && (FEN[1] == '3' || FEN[1] == '6')) {
+        Pos -> EnPassant = CHESS_SQUARE(FEN[0] - 'a', FEN[1] - '1');
+        FEN += 2;
+    } else if (*FEN++ != '-') {
+        return EMBERS_FALSE;
+    }
+
+    /* The move counters are optional.                                        */
+    sscanf(FEN, "%d %d", &Pos -> HalfmoveClock, &Pos -> FullmoveNumber);
+    Pos -> Key = PositionKey(Pos);
+    return EMBERS_TRUE;
+}
+
+void PositionMakeMove(ChessPosition *Pos, ChessMove Move)
+{
+    /* Rights that survive a move touching each square.                       */
+    static const unsigned char CastlingKept[64] = {
+        0xd, 0xf, 0xf, 0xf, 0xc, 0xf, 0xf, 0xe,
+        0xf, 0xf, 0xf, 0xf, 0xf, 0xf, 0xf, 0xf,
+        0xf, 0xf, 0xf, 0xf, 0xf, 0xf, 0xf, 0xf,
+        0xf, 0xf, 0xf, 0xf, 0xf, 0xf, 0xf, 0xf,
+        0xf, 0xf, 0xf, 0xf, 0xf, 0xf, 0xf, 0xf,
+        0xf, 0xf, 0xf, 0xf, 0xf, 0xf, 0xf, 0xf,
+        0xf, 0xf, 0xf, 0xf, 0xf, 0xf, 0xf, 0xf,
+        0x7, 0xf, 0xf, 0xf, 0x3, 0xf, 0xf, 0xb,
+    };
+    int From = MoveFrom(Move),
+        To = MoveTo(Move),
+        Flags = MoveFlags(Move),
+        Us = Pos -> SideToMove,
+        Up = Us == CHESS_WHITE ? 8 : -8;
+    ChessUndo *Undo = &Pos -> History[Pos -> HistoryLength++];
+
+    Undo -> Move = MoveBase(Move);
+    Undo -> Captured = CHESS_NO_PIECE;
+    Undo -> Castling = Pos -> Castling;
+    Undo -> EnPassant = Pos -> EnPassant;
+    Undo -> HalfmoveClock = Pos -> HalfmoveClock;
+    Undo -> Key = Pos -> Key;
+
+    Pos -> Key ^= EnPassantKey(Pos -> EnPassant) ^ PositionZobrist.Side;
+    Pos -> EnPassant = CHESS_NO_SQUARE;
+    Pos -> HalfmoveClock++;
+
+    if (Flags == CHESS_MOVE_EN_PASSANT) {
+        Undo -> Captured = Pos -> Squares[To - Up];
+        PositionRemovePiece(Pos, To - Up);
+    } else if (Flags & CHESS_MOVE_CAPTURE) {
+        Undo -> Captured = Pos -> Squares[To];
+        PositionRemovePiece(Pos, To);
+    }
+
+    if (Flags & CHESS_MOVE_CAPTURE ||
+            CHESS_PIECE_TYPE(Pos -> Squares[From]) == CHESS_PAWN)
+        Pos -> HalfmoveClock = 0;
+
+    PositionMovePiece(Pos, From, To);
+
+    if (Flags & CHESS_MOVE_PROMOTION) {
+        PositionRemovePiece(Pos, To);
+        PositionSetPiece(Pos,
+                         To,
+                         CHESS_PIECE(Us, MovePromotionType(Move)));
+    } else if (Flags == CHESS_MOVE_DOUBLE_PUSH) {
+        Pos -> EnPassant = From + Up;
+        Pos -> Key ^= EnPassantKey(Pos -> EnPassant);
+    } else if (Flags == CHESS_MOVE_CASTLE_KING) {
+        PositionMovePiece(Pos, From + 3, From + 1);
+    } else if (Flags == CHESS_MOVE_CASTLE_QUEEN) {
+        PositionMovePiece(Pos, From - 4, From - 1);
+    }
+
+    Pos -> Key ^= PositionZobrist.Castling[Pos -> Castling];
+    Pos -> Castling &= CastlingKept[From] & CastlingKept[To];
+    Pos -> Key ^= PositionZobrist.Castling[Pos -> Castling];
+    Pos -> FullmoveNumber += Us;
+    Pos -> SideToMove ^= 1;
+    VerifyKey(Pos);
+}
+
+void PositionMakeNullMove(ChessPosition *Pos)
+{
+    ChessUndo *Undo = &Pos -> History[Pos -> HistoryLength++];
+
+    Undo -> Move = CHESS_NO_MOVE;
+    Undo -> Captured = CHESS_NO_PIECE;
+    Undo -> Castling = Pos -> Castling;
+    Undo -> EnPassant = Pos -> EnPassant;
+    Undo -> HalfmoveClock = Pos -> HalfmoveClock;
+    Undo -> Key = Pos -> Key;
+
+    /* The clock is reset so repetitions aren't looked for across the pass.   */
+    Pos -> Key ^= EnPassantKey(Pos -> EnPassant) ^ PositionZobrist.Side;
+    Pos -> EnPassant = CHESS_NO_SQUARE;
+    Pos -> HalfmoveClock = 0;
+    Pos -> FullmoveNumber += Pos -> SideToMove;
+    Pos -> SideToMove ^= 1;
+    VerifyKey(Pos);
+}
+
+void PositionUnmakeMove(ChessPosition *Pos)
+{
+    const ChessUndo *Undo = &Pos -> History[--Pos -> HistoryLength];
+    int From = MoveFrom(Undo -> Move),
+        To = MoveTo(Undo -> Move),
+        Flags = MoveFlags(Undo -> Move),
+        Us = Pos -> SideToMove ^ 1,
+        Up = Us == CHESS_WHITE ? 8 : -8;
+
+    Pos -> SideToMove = Us;
+    Pos -> FullmoveNumber -= Us;
+
+    if (Undo -> Move == CHESS_NO_MOVE) {
+        Pos -> EnPassant = Undo -> EnPassant;
+        Pos -> HalfmoveClock = Undo -> HalfmoveClock;
+        Pos -> Key = Undo -> Key;
+        return;
+    }
+
+    if (Flags & CHESS_MOVE_PROMOTION) {
+        PositionRemovePiece(Pos, To);
+        PositionSetPiece(Pos, To, CHESS_PIECE(Us, CHESS_PAWN));
+    } else if (Flags == CHESS_MOVE_CASTLE_KING) {
+        PositionMovePiece(Pos, From + 1, From + 3);
+    } else if (Flags == CHESS_MOVE_CASTLE_QUEEN) {
+        PositionMovePiece(Pos, From - 1, From - 4);
+    }
+
+    PositionMovePiece(Pos, To, From);
+
+    if (Flags == CHESS_MOVE_EN_PASSANT)
+        PositionSetPiece(Pos, To - Up, Undo -> Captured);
+    else if (Flags & CHESS_MOVE_CAPTURE)
+        PositionSetPiece(Pos, To, Undo -> Captured);
+
+    Pos -> Castling = Undo -> Castling;
+    Pos -> EnPassant = Undo -> EnPassant;
+    Pos -> HalfmoveClock = Undo -> HalfmoveClock;
+    Pos -> Key = Undo -> Key;
+    VerifyKey(Pos);
+}
+
+ChessKey PositionKey(const ChessPosition *Pos)
+{
+    ChessKey Key = PositionZobrist.Castling[Pos -> Castling];
+    Bitboard Set;
+    int Sq;
+
+    for (int Colour = 0; Colour < 2; Colour++) {
+        for (int Type = 0; Type < CHESS_PIECE_TYPES; Type++) {
+            Set = Pos -> Pieces[Colour][Type];
+            while (Set) {
+                Sq = BitboardPop(&Set);
+                Key ^= PositionZobrist.Pieces[Colour][Type][Sq];
+            }
+        }
+    }
+
+    if (Pos -> EnPassant != CHESS_NO_SQUARE)
+        Key ^= PositionZobrist.EnPassant[CHESS_FILE(Pos -> EnPassant)];
+
+    if (Pos -> SideToMove == CHESS_BLACK)
+        Key ^= PositionZobrist.Side;
+
+    return Key;
+}
+
+/* Only a position with the same side to move can repeat, and none from       */
+/* before the last irreversible move.                                         */
+EMBERS_BOOL PositionIsRepetition(const ChessPosition *Pos)
+{
+    int Oldest = Pos -> HistoryLength - Pos -> HalfmoveClock;
+
+    for (int i = Pos -> HistoryLength - 4; i >= 0 && i >= Oldest; i -= 2) {
+        if (Pos -> History[i].Key == Pos -> Key)
+            return EMBERS_TRUE;
+    }
+
+    return EMBERS_FALSE;
+}
+
+void PositionTrimHistory(ChessPosition *Pos, int Keep)
+{
+    int Drop;
+
+    if (Keep > Pos -> HalfmoveClock)
+        Keep = Pos -> HalfmoveClock;
+
+    if ((Drop = Pos -> HistoryLength - Keep) <= 0)
+        return;
+
+    memmove(Pos -> History,
+            Pos -> History + Drop,
+            sizeof(*Pos -> History) * Keep);
+    Pos -> HistoryLength = Keep;
+}
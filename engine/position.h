@@ -0,0 +1,287 @@
+/******************************************************************************\
+*  position.h                                                                  *
+*                                                                              *
+*  The chess position, the engine's source of truth for the game state.        *
+*  Pieces are kept as twelve bitboards plus occupancy masks and a mailbox.     *
+*                                                                              *
+*              Written by Abed Na'ran                          October 2026    *
+*                                                                              *
+\******************************************************************************/
+#ifndef POSITION_H
+#define POSITION_H
+#include "config.h"
+#include "bitboard.h"
+#include "move.h"
+
+enum {
+    CHESS_WHITE = 0,
+    CHESS_BLACK = 1,
+    CHESS_BOTH = 2
+};
+
+/* Same order as the CHESS_FLAG_* piece values in chess.h.                    */
+enum {
+    CHESS_KING = 0,
+    CHESS_QUEEN,
+    CHESS_ROOK,
+    CHESS_KNIGHT,
+    CHESS_BISHOP,
+    CHESS_PAWN,
+    CHESS_PIECE_TYPES
+};
+
+enum {
+    CHESS_CASTLE_WHITE_KING = 0x01,
+    CHESS_CASTLE_WHITE_QUEEN = 0x02,
+    CHESS_CASTLE_BLACK_KING = 0x04,
+    CHESS_CASTLE_BLACK_QUEEN = 0x08,
+};
+
+/* A piece packs its colour in bit 3 and its type in the low bits.            */
+#define CHESS_PIECE(Colour, Type) (((Colour) << 3) | (Type))
+#define CHESS_PIECE_COLOUR(Piece) ((Piece) >> 3)
+#define CHESS_PIECE_TYPE(Piece) ((Piece) & 0x07)
+#define CHESS_NO_PIECE (CHESS_PIECE_TYPES)
+
+/* A Zobrist hash of the position.                                            */
+typedef uint64_t ChessKey;
+
+/* The random keys XORed together into a ChessKey.                            */
+typedef struct ChessZobrist {
+    ChessKey Pieces[2][CHESS_PIECE_TYPES][64];
+    ChessKey Castling[16]; /* One per combination of CHESS_CASTLE_* rights.   */
+    ChessKey EnPassant[8]; /* By the file of the en passant square.           */
+    ChessKey Side; /* Black to move.                                          */
+} ChessZobrist;
+
+extern const ChessZobrist PositionZobrist;
+
+/* Deepest line PositionMakeMove can walk before it has to be unmade.         */
+#define CHESS_MAX_HISTORY (256)
+
+/* What a move destroys, enough to take it back.                              */
+typedef struct ChessUndo {
+    ChessMove Move;
+    unsigned char Captured; /* The captured piece or CHESS_NO_PIECE.          */
+    unsigned char Castling;
+    unsigned char EnPassant;
+    int HalfmoveClock;
+    ChessKey Key; /* The key before the move, what repetitions are found by.  */
+} ChessUndo;
+
+typedef struct ChessPosition {
+    Bitboard Pieces[2][CHESS_PIECE_TYPES]; /* One set per colour and type.    */
+    Bitboard Occupancy[3]; /* White, black and both.                          */
+    unsigned char Squares[64]; /* The piece on each square.                   */
+    int SideToMove;
+    int Castling; /* CHESS_CASTLE_* rights still available.                   */
+    int EnPassant; /* The en passant target square or CHESS_NO_SQUARE.        */
+    int HalfmoveClock;
+    int FullmoveNumber;
+    ChessKey Key; /* Kept up to date by every change, see PositionKey.        */
+    ChessUndo History[CHESS_MAX_HISTORY]; /* The undo stack.                  */
+    int HistoryLength;
+} ChessPosition;
+
+/******************************************************************************\
+* PositionClear                                                                *
+*                                                                              *
+*  Empty the position, white to move with no castling rights and an empty      *
+*  undo stack.                                                                 *
+*                                                                              *
+* Parameters                                                                   *
+*                                                                              *
+*  -Pos: The position.                                                         *
+*                                                                              *
+* Return                                                                       *
+*                                                                              *
+*  -void.                                                                      *
+*                                                                              *
+\******************************************************************************/
+void PositionClear(ChessPosition *Pos);
+
+/******************************************************************************\
+* PositionInferCastling                                                        *
+*                                                                              *
+*  Grant every castling right whose king and rook stand on their starting      *
+*  squares, used when a position is loaded without move history.               *
+*                                                                              *
+* Parameters                                                                   *
+*                                                                              *
+*  -Pos: The position.                                                         *
+*                                                                              *
+* Return                                                                       *
+*                                                                              *
+*  -void.                                                                      *
+*                                                                              *
+\******************************************************************************/
+void PositionInferCastling(ChessPosition *Pos);
+
+/******************************************************************************\
+* PositionFromFEN                                                              *
+*                                                                              *
+*  Load a position from Forsyth-Edwards notation. The move counters may be     *
+*  left out.                                                                   *
+*                                                                              *
+* Parameters                                                                   *
+*                                                                              *
+*  -Pos: The position, cleared first.                                          *
+*  -FEN: The FEN string.                                                       *
+*                                                                              *
+* Return                                                                       *
+*                                                                              *
+*  -EMBERS_BOOL: EMBERS_FALSE if the string is malformed.                      *
+*                                                                              *
+\******************************************************************************/
+EMBERS_BOOL PositionFromFEN(ChessPosition *Pos, const char *FEN);
+
+/******************************************************************************\
+* PositionMakeMove                                                             *
+*                                                                              *
+*  Play a legal move, handling captures, castling, en passant, promotions,     *
+*  the castling rights and the move counters. The move is pushed on the undo   *
+*  stack, at most CHESS_MAX_HISTORY moves can be pending.                      *
+*                                                                              *
+* Parameters                                                                   *
+*                                                                              *
+*  -Pos: The position.                                                         *
+*  -Move: A legal move for the side to move.                                   *
+*                                                                              *
+* Return                                                                       *
+*                                                                              *
+*  -void.                                                                      *
+*                                                                              *
+\******************************************************************************/
+void PositionMakeMove(ChessPosition *Pos, ChessMove Move);
+
+/******************************************************************************\
+* PositionUnmakeMove                                                           *
+*                                                                              *
+*  Take back the last move made with PositionMakeMove or a null move.          *
+*                                                                              *
+* Parameters                                                                   *
+*                                                                              *
+*  -Pos: The position, its undo stack must not be empty.                       *
+*                                                                              *
+* Return                                                                       *
+*                                                                              *
+*  -void.                                                                      *
+*                                                                              *
+\******************************************************************************/
+void PositionUnmakeMove(ChessPosition *Pos);
+
+/******************************************************************************\
+* PositionMakeNullMove                                                         *
+*                                                                              *
+*  Pass the move to the other side, for null move pruning. The position must   *
+*  not be in check. It's pushed on the undo stack as CHESS_NO_MOVE and taken   *
+*  back with PositionUnmakeMove, no repetition reaches back past it.           *
+*                                                                              *
+* Parameters                                                                   *
+*                                                                              *
+*  -Pos: The position.                                                         *
+*                                                                              *
+* Return                                                                       *
+*                                                                              *
+*  -void.                                                                      *
+*                                                                              *
+\******************************************************************************/
+void PositionMakeNullMove(ChessPosition *Pos);
+
+/******************************************************************************\
+* PositionKey                                                                  *
+*                                                                              *
+*  Hash the position from scratch, the pieces, the side to move, the castling  *
+*  rights and the en passant square. The move counters are left out. Pos ->    *
+*  Key always holds the same value, this is for setting it up and checking it. *
+*                                                                              *
+* Parameters                                                                   *
+*                                                                              *
+*  -Pos: The position.                                                         *
+*                                                                              *
+* Return                                                                       *
+*                                                                              *
+*  -ChessKey: The Zobrist key.                                                 *
+*                                                                              *
+\******************************************************************************/
+ChessKey PositionKey(const ChessPosition *Pos);
+
+/******************************************************************************\
+* PositionIsRepetition                                                         *
+*                                                                              *
+*  Check whether the position already happened since the last capture or pawn  *
+*  move, as far back as the undo stack goes.                                   *
+*                                                                              *
+* Parameters                                                                   *
+*                                                                              *
+*  -Pos: The position.                                                         *
+*                                                                              *
+* Return                                                                       *
+*                                                                              *
+*  -EMBERS_BOOL: EMBERS_TRUE if the position is a repetition.                  *
+*                                                                              *
+\******************************************************************************/
+EMBERS_BOOL PositionIsRepetition(const ChessPosition *Pos);
+
+/******************************************************************************\
+* PositionTrimHistory                                                          *
+*                                                                              *
+*  Drop the oldest moves from the undo stack, keeping the ones a repetition    *
+*  could still go back to. The dropped moves can't be unmade any more.         *
+*                                                                              *
+* Parameters                                                                   *
+*                                                                              *
+*  -Pos: The position.                                                         *
+*  -Keep: The most moves to keep.                                              *
+*                                                                              *
+* Return                                                                       *
+*                                                                              *
+*  -void.                                                                      *
+*                                                                              *
+\******************************************************************************/
+void PositionTrimHistory(ChessPosition *Pos, int Keep);
+
+/* Place Piece on the empty square Sq.                                        */
+static inline void PositionSetPiece(ChessPosition *Pos, int Sq, int Piece)
+{
+    Bitboard Bit = BITBOARD_SQUARE(Sq);
+    int Colour = CHESS_PIECE_COLOUR(Piece);
+
+    Pos -> Pieces[Colour][CHESS_PIECE_TYPE(Piece)] |= Bit;
+    Pos -> Occupancy[Colour] |= Bit;
+    Pos -> Occupancy[CHESS_BOTH] |= Bit;
+    Pos -> Squares[Sq] = Piece;
+    Pos -> Key ^= PositionZobrist.Pieces[Colour][CHESS_PIECE_TYPE(Piece)][Sq];
+}
+
+/* Clear the occupied square Sq.                                              */
+static inline void PositionRemovePiece(ChessPosition *Pos, int Sq)
+{
+    Bitboard Bit = BITBOARD_SQUARE(Sq);
+    int Piece = Pos -> Squares[Sq],
+        Colour = CHESS_PIECE_COLOUR(Piece);
+
+    Pos -> Pieces[Colour][CHESS_PIECE_TYPE(Piece)] ^= Bit;
+    Pos -> Occupancy[Colour] ^= Bit;
+    Pos -> Occupancy[CHESS_BOTH] ^= Bit;
+    Pos -> Squares[Sq] = CHESS_NO_PIECE;
+    Pos -> Key ^= PositionZobrist.Pieces[Colour][CHESS_PIECE_TYPE(Piece)][Sq];
+}
+
+/* Move the piece on From to the empty square To.                             */
+static inline void PositionMovePiece(ChessPosition *Pos, int From, int To)
+{
+    Bitboard Bits = BITBOARD_SQUARE(From) | BITBOARD_SQUARE(To);
+    int Piece = Pos -> Squares[From],
+        Colour = CHESS_PIECE_COLOUR(Piece);
+
+    Pos -> Pieces[Colour][CHESS_PIECE_TYPE(Piece)] ^= Bits;
+    Pos -> Occupancy[Colour] ^= Bits;
+    Pos -> Occupancy[CHESS_BOTH] ^= Bits;
+    Pos -> Squares[To] = Piece;
+    Pos -> Squares[From] = CHESS_NO_PIECE;
+    Pos -> Key ^= PositionZobrist.Pieces[Colour][CHESS_PIECE_TYPE(Piece)][From] ^
+                  PositionZobrist.Pieces[Colour][CHESS_PIECE_TYPE(Piece)][To];
+}
+
+#endif /* POSITION_H */
@@ -0,0 +1,747 @@
+#include "search.h"
+#include "eval.h"
+#include "movegen.h"
+#include "picker.h"
+#include "see.h"
+#include "timeman.h"
+#include <time.h>
+#include <string.h>
+#include <pthread.h>
+
+/* Margins per ply of depth left, in centipawns.                              */
+#define SEARCH_FUTILITY_MARGIN (120)
+#define SEARCH_REVERSE_FUTILITY_MARGIN (80)
+
+/* The deepest nodes futility pruning applies to.                             */
+#define SEARCH_FUTILITY_DEPTH (3)
+#define SEARCH_REVERSE_FUTILITY_DEPTH (6)
+
+/* History past this either way changes a late move's reduction by a ply.     */
+/* Bonuses grow with depth squared, so at usual depths history stays far      */
+/* below SEARCH_HISTORY_MAX.                                                  */
+#define SEARCH_LMR_HISTORY (512)
+
+/* The quiet moves a node remembers trying, to lower their history when a     */
+/* later one cuts off.                                                        */
+#define SEARCH_MAX_QUIETS (64)
+
+/* Lazy SMP helpers skip iterations in blocks, helper Id on pattern           */
+/* (Id - 1) % SEARCH_SKIP_PATTERNS, skipping Depth when                       */
+/* (Depth + SkipPhase) / SkipSize is odd. The threads then spread over many   */
+/* depths instead of racing through the same tree two at a time.              */
+#define SEARCH_SKIP_PATTERNS (20)
+
+static const int SkipSize[SEARCH_SKIP_PATTERNS] = {
+    1, 1, 2, 2, 2, 2, 3, 3, 3, 3, 3, 3, 4, 4, 4, 4, 4, 4, 4, 4
+};
+
+static const int SkipPhase[SEARCH_SKIP_PATTERNS] = {
+    0, 1, 0, 1, 2, 3, 0, 1, 2, 3, 4, 5, 0, 1, 2, 3, 4, 5, 6, 7
+};
+
+/* A helper thread of SearchParallel.                                         */
+typedef struct SearchHelper {
+    pthread_t Thread;
+    SearchContext *Ctx;
+    const ChessPosition *Pos;
+    const SearchLimits *Limits;
+    SearchResult Result;
+} SearchHelper;
+
+static inline double Now();
+static inline void Poll(SearchContext *Ctx);
+static inline EMBERS_BOOL Pondering(const SearchContext *Ctx);
+static inline int ScoreToTable(int Score, int Ply);
+static inline int ScoreFromTable(int Score, int Ply);
+static inline void AddHistory(int *Entry, int Bonus);
+static void UpdateQuiets(SearchContext *Ctx,
+                         int Ply,
+                         int Depth,
+                         ChessMove Move,
+                         const ChessMove *Quiets,
+                         int QuietCount);
+static inline EMBERS_BOOL HasPieces(const ChessPosition *Pos);
+static inline EMBERS_BOOL SkipDepth(int Id, int Depth);
+static inline int Reduction(const SearchContext *Ctx,
+                            int Side,
+                            int Depth,
+                            int Index,
+                            ChessMove Move);
+static int Quiesce(SearchContext *Ctx, int Ply, int Alpha, int Beta);
+static void Statistics(const SearchContext *Ctx, SearchResult *Result);
+static int Negamax(SearchContext *Ctx, int Depth, int Ply, int Alpha, int Beta);
+static inline EMBERS_BOOL Excluded(const SearchContext *Ctx, ChessMove Move);
+static int Aspiration(SearchContext *Ctx, int Depth, const SearchLine *Last);
+static void *HelperThread(void *Data);
+
+double Now()
+{
+    struct timespec Time;
+
+    clock_gettime(CLOCK_MONOTONIC, &Time);
+    return Time.tv_sec + Time.tv_nsec / 1e9;
+}
+
+EMBERS_BOOL Pondering(const SearchContext *Ctx)
+{
+    return Ctx -> Limits.Ponder &&
+           __atomic_load_n(Ctx -> Limits.Ponder, __ATOMIC_RELAXED);
+}
+
+/* The node budget and stop flag are checked every node, the clock only every */
+/* so often. The first iteration always finishes, LastPV is only filled once  */
+/* it has.                                                                    */
+void Poll(SearchContext *Ctx)
+{
+    if (!Ctx -> LastPVLength)
+        return;
+
+    if (Ctx -> Limits.Nodes && Ctx -> Nodes >= Ctx -> Limits.Nodes)
+        Ctx -> Stop = EMBERS_TRUE;
+
+    if (Ctx -> Limits.Stop &&
+            __atomic_load_n(Ctx -> Limits.Stop, __ATOMIC_RELAXED))
+        Ctx -> Stop = EMBERS_TRUE;
+
+    if (Ctx -> Limits.Seconds > 0 &&
+            !(Ctx -> Nodes % SEARCH_POLL_NODES) && !Pondering(Ctx) &&
+            Now() - Ctx -> Start >= Ctx -> Limits.Seconds)
+        Ctx -> Stop = EMBERS_TRUE;
+}
+
+/* Mate scores count plies from the root, the table stores them counted from  */
+/* the node so they stay right wherever the position turns up again.          */
+int ScoreToTable(int Score, int Ply)
+{
+    if (Score >= EVAL_MATE_BOUND)
+        return Score + Ply;
+
+    if (Score <= -EVAL_MATE_BOUND)
+        return Score - Ply;
+
+    return Score;
+}
+
+int ScoreFromTable(int Score, int Ply)
+{
+    if (Score >= EVAL_MATE_BOUND)
+        return Score - Ply;
+
+    if (Score <= -EVAL_MATE_BOUND)
+        return Score + Ply;
+
+    return Score;
+}
+
+/* Move an entry towards SEARCH_HISTORY_MAX or its negative, by less the      */
+/* closer it already is, so it never leaves the range.                        */
+void AddHistory(int *Entry, int Bonus)
+{
+    int Size = Bonus < 0 ? -Bonus : Bonus;
+
+    *Entry += Bonus - *Entry * Size / SEARCH_HISTORY_MAX;
+}
+
+/* A quiet move cut off, remember it for the siblings and the next visit, and */
+/* count against the quiet moves that didn't.                                 */
+void UpdateQuiets(SearchContext *Ctx,
+                  int Ply,
+                  int Depth,
+                  ChessMove Move,
+                  const ChessMove *Quiets,
+                  int QuietCount)
+{
+    const ChessPosition *Pos = &Ctx -> Pos;
+    int (*History)[64] = Ctx -> History[Pos -> SideToMove],
+        Bonus = Depth * Depth > 400 ? 400 : Depth * Depth;
+    ChessMove Last;
+
+    if (Ctx -> Killers[Ply][0] != Move) {
+        Ctx -> Killers[Ply][1] = Ctx -> Killers[Ply][0];
+        Ctx -> Killers[Ply][0] = Move;
+    }
+
+    AddHistory(&History[MoveFrom(Move)][MoveTo(Move)], Bonus);
+    for (int i = 0; i < QuietCount; i++)
+        AddHistory(&History[MoveFrom(Quiets[i])][MoveTo(Quiets[i])], -Bonus);
+
+    if (Pos -> HistoryLength) {
+        Last = Pos -> History[Pos -> HistoryLength - 1].Move;
+        Ctx -> Counters[MoveFrom(Last)][MoveTo(Last)] = Move;
+    }
+}
+
+/* Whether the side to move has more than king and pawns. Without, passing is */
+/* often its best move and a null move search would lie.                      */
+EMBERS_BOOL HasPieces(const ChessPosition *Pos)
+{
+    const Bitboard *Ours = Pos -> Pieces[Pos -> SideToMove];
+
+    return (Ours[CHESS_QUEEN] | Ours[CHESS_ROOK] |
+            Ours[CHESS_KNIGHT] | Ours[CHESS_BISHOP]) != 0;
+}
+
+/* How much shallower to search the Index-th quiet move Side played, later    */
+/* moves and ones with a poor history are trusted less.                       */
+int Reduction(const SearchContext *Ctx,
+              int Side,
+              int Depth,
+              int Index,
+              ChessMove Move)
+{
+    int History = Ctx -> History[Side][MoveFrom(Move)][MoveTo(Move)],
+        R = 1 + (Index >= 6) + (Depth >= 6);
+
+    if (History > SEARCH_LMR_HISTORY)
+        R--;
+    else if (History < -SEARCH_LMR_HISTORY)
+        R++;
+
+    /* Never straight into the quiescence search.                             */
+    if (R > Depth - 2)
+        R = Depth - 2;
+
+    return R > 0 ? R : 0;
+}
+
+/* Play out the captures until the position is quiet, so a leaf is never      */
+/* scored halfway through an exchange. The side to move may stand on the      */
+/* static score instead, unless it's in check and has to get out first.       */
+int Quiesce(SearchContext *Ctx, int Ply, int Alpha, int Beta)
+{
+    ChessPosition *Pos = &Ctx -> Pos;
+    MovePicker Picker;
+    ChessMove Move;
+    EMBERS_BOOL InCheck = MoveGenInCheck(Pos);
+    int Score, Best = -EVAL_INFINITE, Played = 0;
+
+    Ctx -> PVLength[Ply] = Ply;
+    Ctx -> Nodes++;
+    Poll(Ctx);
+
+    if (Ctx -> Stop)
+        return 0;
+
+    if (Ply >= SEARCH_MAX_PLY - 1)
+        return EvalPosition(Pos);
+
+    if (InCheck) {
+        PickerInit(&Picker, Pos, CHESS_NO_MOVE, NULL, CHESS_NO_MOVE, NULL);
+    } else {
+        Best = EvalPosition(Pos);
+        if (Best >= Beta)
+            return Best;
+
+        if (Best > Alpha)
+            Alpha = Best;
+
+        PickerInitCaptures(&Picker, Pos);
+    }
+
+    while ((Move = PickerNext(&Picker)) != CHESS_NO_MOVE) {
+        Played++;
+
+        /* Standing pat already beats a capture that loses material.          */
+        if (!InCheck && SeeMove(Pos, Move) < 0)
+            continue;
+
+        PositionMakeMove(Pos, Move);
+        Score = -Quiesce(Ctx, Ply + 1, -Beta, -Alpha);
+        PositionUnmakeMove(Pos);
+
+        if (Ctx -> Stop)
+            return 0;
+
+        if (Score <= Best)
+            continue;
+
+        Best = Score;
+        if (Score > Alpha)
+            Alpha = Score;
+
+        if (Alpha >= Beta)
+            break;
+    }
+
+    if (InCheck && !Played)
+        return -EVAL_MATE + Ply;
+
+    return Best;
+}
+
+/* Copy the counters and the time taken so far into Result.                   */
+void Statistics(const SearchContext *Ctx, SearchResult *Result)
+{
+    Result -> Nodes = Ctx -> Nodes;
+    Result -> Probes = Ctx -> Probes;
+    Result -> Hits = Ctx -> Hits;
+    Result -> Cutoffs = Ctx -> Cutoffs;
+    Result -> FirstCutoffs = Ctx -> FirstCutoffs;
+    Result -> Fill = Ctx -> Table ? TTFill(Ctx -> Table) : 0;
+    Result -> Seconds = Now() - Ctx -> Start;
+}
+
+int Negamax(SearchContext *Ctx, int Depth, int Ply, int Alpha, int Beta)
+{
+    ChessPosition *Pos = &Ctx -> Pos;
+    MovePicker Picker;
+    ChessMove Move, Hash = CHESS_NO_MOVE, BestMove, Counter = CHESS_NO_MOVE,
+              Last = CHESS_NO_MOVE, Quiets[SEARCH_MAX_QUIETS];
+    ChessKey Key = Pos -> Key;
+    TTHit Hit;
+    EMBERS_BOOL InCheck, Quiet, PVNode;
+    int Score, Best = -EVAL_INFINITE, Played = 0, OldAlpha = Alpha,
+        QuietCount = 0, Eval = 0, R;
+
+    Ctx -> PVLength[Ply] = Ply;
+    if (Ply && (Pos -> HalfmoveClock >= 100 || PositionIsRepetition(Pos)))
+        return 0;
+
+    if (Depth <= 0)
+        return Quiesce(Ctx, Ply, Alpha, Beta);
+
+    Ctx -> Nodes++;
+    Poll(Ctx);
+
+    if (Ctx -> Stop)
+        return 0;
+
+    if (Ply >= SEARCH_MAX_PLY - 1)
+        return EvalPosition(Pos);
+
+    /* Under PVS only the PV is searched with a window wider than null.       */
+    PVNode = Ctx -> Pruning & SEARCH_PVS && Beta - Alpha > 1;
+
+    Ctx -> Probes += Ctx -> Table != NULL;
+    if (Ctx -> Table && TTProbe(Ctx -> Table, Key, &Hit)) {
+        Ctx -> Hits++;
+        Hash = Hit.Move;
+        Score = ScoreFromTable(Hit.Score, Ply);
+
+        /* The root and the rest of the PV always search, a cutoff there      */
+        /* would leave the PV cut short, without the reply to ponder on.      */
+        if (Ply && !PVNode && Hit.Depth >= Depth &&
+                (Hit.Bound == TT_EXACT ||
+                 (Hit.Bound == TT_LOWER && Score >= Beta) ||
+                 (Hit.Bound == TT_UPPER && Score <= Alpha)))
+            return Score;
+    }
+
+    if (Ctx -> FollowPV) {
+        if (Ply < Ctx -> LastPVLength)
+            Hash = Ctx -> LastPV[Ply];
+        else
+            Ctx -> FollowPV = EMBERS_FALSE;
+    }
+
+    if (Pos -> HistoryLength) {
+        Last = Pos -> History[Pos -> HistoryLength - 1].Move;
+        Counter = Ctx -> Counters[MoveFrom(Last)][MoveTo(Last)];
+    }
+
+    /* Nothing is pruned in check, on the last iteration's line or at the     */
+    /* root, and mate scores are never pruned towards. Under PVS whole nodes  */
+    /* are only pruned off the PV, where the window is null.                  */
+    InCheck = MoveGenInCheck(Pos);
+    if (!InCheck)
+        Eval = EvalPosition(Pos);
+
+    if (Ply && !InCheck && !PVNode && !Ctx -> FollowPV &&
+            Beta < EVAL_MATE_BOUND && Beta > -EVAL_MATE_BOUND) {
+        if (Ctx -> Pruning & SEARCH_REVERSE_FUTILITY &&
+                Depth <= SEARCH_REVERSE_FUTILITY_DEPTH &&
+                Eval - SEARCH_REVERSE_FUTILITY_MARGIN * Depth >= Beta)
+            return Eval;
+
+        /* Two passes in a row prove nothing, and neither does one with only  */
+        /* king and pawns, where zugzwang is common.                          */
+        if (Ctx -> Pruning & SEARCH_NULL_MOVE &&
+                Depth >= 3 && Eval >= Beta && HasPieces(Pos) &&
+                Pos -> HistoryLength && Last != CHESS_NO_MOVE) {
+            R = 2 + Depth / 4;
+            PositionMakeNullMove(Pos);
+            Score = -Negamax(Ctx, Depth - 1 - R, Ply + 1, -Beta, -Beta + 1);
+            PositionUnmakeMove(Pos);
+
+            if (Ctx -> Stop)
+                return 0;
+
+            if (Score >= Beta)
+                return Score < EVAL_MATE_BOUND ? Score : Beta;
+        }
+    }
+
+    BestMove = Hash;
+    PickerInit(&Picker,
+               Pos,
+               Hash,
+               Ctx -> Killers[Ply],
+               Counter,
+               Ctx -> History[Pos -> SideToMove]);
+    while ((Move = PickerNext(&Picker)) != CHESS_NO_MOVE) {
+        Quiet = !MoveIsCapture(Move) && !MoveIsPromotion(Move);
+
+        /* Root moves that already have a line this iteration.                */
+        if (!Ply && Excluded(Ctx, Move)) {
+            Ctx -> FollowPV = EMBERS_FALSE;
+            continue;
+        }
+
+        /* This quiet move would need to win more than the margin to matter.  */
+        /* Root moves are all searched, a multi-PV pass may need any of them. */
+        if (Ctx -> Pruning & SEARCH_FUTILITY && Ply && Played && Quiet &&
+                !InCheck && Depth <= SEARCH_FUTILITY_DEPTH &&
+                Alpha > -EVAL_MATE_BOUND && Alpha < EVAL_MATE_BOUND &&
+                Eval + SEARCH_FUTILITY_MARGIN * Depth <= Alpha)
+            continue;
+
+        PositionMakeMove(Pos, Move);
+        if (Ctx -> Table)
+            TTPrefetch(Ctx -> Table, Pos -> Key);
+
+        /* Late quiet moves are searched shallower first, and again at full   */
+        /* depth only if they turn out to beat alpha. Checks and root moves   */
+        /* aren't reduced.                                                    */
+        R = 0;
+        if (Ctx -> Pruning & SEARCH_LMR && Ply && Depth >= 3 && Played >= 3 &&
+                Quiet && !InCheck && !MoveGenInCheck(Pos))
+            R = Reduction(Ctx, Pos -> SideToMove ^ 1, Depth, Played, Move);
+
+        /* After the first move the rest only have to be proven worse, with   */
+        /* a null window, and get a full one only when that fails.            */
+        if (Played && Ctx -> Pruning & SEARCH_PVS) {
+            Score = -Negamax(Ctx, Depth - 1 - R, Ply + 1, -Alpha - 1, -Alpha);
+            if (R && Score > Alpha && !Ctx -> Stop)
+                Score = -Negamax(Ctx, Depth - 1, Ply + 1, -Alpha - 1, -Alpha);
+
+            if (Score > Alpha && Score < Beta && !Ctx -> Stop)
+                Score = -Negamax(Ctx, Depth - 1, Ply + 1, -Beta, -Alpha);
+        } else {
+            Score = -Negamax(Ctx, Depth - 1 - R, Ply + 1, -Beta, -Alpha);
+            if (R && Score > Alpha && !Ctx -> Stop)
+                Score = -Negamax(Ctx, Depth - 1, Ply + 1, -Beta, -Alpha);
+        }
+
+        PositionUnmakeMove(Pos);
+
+        /* Only the first move of a node can be on the last iteration's PV.   */
+        Ctx -> FollowPV = EMBERS_FALSE;
+        Played++;
+
+        if (Ctx -> Stop)
+            return 0;
+
+        if (Score < Beta && Quiet && QuietCount < SEARCH_MAX_QUIETS)
+            Quiets[QuietCount++] = Move;
+
+        if (Score <= Best)
+            continue;
+
+        Best = Score;
+        if (Score <= Alpha)
+            continue;
+
+        Alpha = Score;
+        BestMove = Move;
+        Ctx -> PV[Ply][Ply] = Move;
+        for (int i = Ply + 1; i < Ctx -> PVLength[Ply + 1]; i++)
+            Ctx -> PV[Ply][i] = Ctx -> PV[Ply + 1][i];
+
+        Ctx -> PVLength[Ply] = Ctx -> PVLength[Ply + 1];
+
+        if (Alpha >= Beta) {
+            Ctx -> Cutoffs++;
+            Ctx -> FirstCutoffs += Played == 1;
+            if (Quiet)
+                UpdateQuiets(Ctx, Ply, Depth, Move, Quiets, QuietCount);
+
+            break;
+        }
+    }
+
+    /* Mated, or stalemate. Futility never skips the first move, so a node    */
+    /* with moves always plays one.                                           */
+    if (!Played)
+        return InCheck ? -EVAL_MATE + Ply : 0;
+
+    /* A root with moves left out has no score of its own to store.           */
+    if (Ctx -> Table && (Ply || !Ctx -> ExcludedCount))
+        TTStore(Ctx -> Table,
+                Key,
+                BestMove,
+                ScoreToTable(Best, Ply),
+                Depth,
+                Best >= Beta ? TT_LOWER :
+                Best > OldAlpha ? TT_EXACT : TT_UPPER);
+
+    return Best;
+}
+
+EMBERS_BOOL SkipDepth(int Id, int Depth)
+{
+    int Pattern = (Id - 1) % SEARCH_SKIP_PATTERNS;
+
+    return Id && (Depth + SkipPhase[Pattern]) / SkipSize[Pattern] % 2;
+}
+
+EMBERS_BOOL Excluded(const SearchContext *Ctx, ChessMove Move)
+{
+    for (int i = 0; i < Ctx -> ExcludedCount; i++) {
+        if (Ctx -> Excluded[i] == MoveBase(Move))
+            return EMBERS_TRUE;
+    }
+
+    return EMBERS_FALSE;
+}
+
+/* Search the root to Depth for one line, following Last, that line from the  */
+/* iteration before, first. Its score sets the aspiration window, which is    */
+/* widened on whichever side the score falls out of until it lands inside.    */
+int Aspiration(SearchContext *Ctx, int Depth, const SearchLine *Last)
+{
+    int Alpha = -EVAL_INFINITE,
+        Beta = EVAL_INFINITE,
+        Delta = SEARCH_ASPIRATION_WINDOW,
+        Score;
+
+    if (Last) {
+        for (int i = 0; i < Last -> PVLength; i++)
+            Ctx -> LastPV[i] = Last -> PV[i];
+
+        Ctx -> LastPVLength = Last -> PVLength;
+    }
+
+    if (Ctx -> Pruning & SEARCH_ASPIRATION && Last &&
+            Depth >= SEARCH_ASPIRATION_DEPTH &&
+            Last -> Score > -EVAL_MATE_BOUND &&
+            Last -> Score < EVAL_MATE_BOUND) {
+        Alpha = Last -> Score - Delta;
+        Beta = Last -> Score + Delta;
+    }
+
+    for (;;) {
+        Ctx -> FollowPV = Last != NULL;
+        Score = Negamax(Ctx, Depth, 0, Alpha, Beta);
+        if (Ctx -> Stop)
+            return 0;
+
+        if (Score <= Alpha)
+            Alpha = Score - Delta > -EVAL_INFINITE ? Score - Delta :
+                                                     -EVAL_INFINITE;
+        else if (Score >= Beta)
+            Beta = Score + Delta < EVAL_INFINITE ? Score + Delta :
+                                                   EVAL_INFINITE;
+        else
+            return Score;
+
+        Delta *= 2;
+    }
+}
+
+void SearchRun(SearchContext *Ctx,
+               const ChessPosition *Pos,
+               const SearchLimits *Limits,
+               SearchResult *Result)
+{
+    int MaxDepth = Limits -> Depth > 0 && Limits -> Depth < SEARCH_MAX_PLY ?
+                   Limits -> Depth : SEARCH_MAX_PLY - 1,
+        Lines, Mates, Stable = 0;
+    double Instability = 0;
+    ChessMove Previous;
+    MoveList Moves;
+    SearchLine *Line, Swap;
+    EMBERS_BOOL Forced;
+
+    /* There can't be more lines than root moves, and with only one move      */
+    /* there is nothing to think about under a clock.                         */
+    MoveGenLegal(Pos, &Moves);
+    Lines = Ctx -> MultiPV < SEARCH_MAX_LINES ? Ctx -> MultiPV :
+                                                SEARCH_MAX_LINES;
+    if (Lines > Moves.Count)
+        Lines = Moves.Count;
+
+    if (Lines < 1)
+        Lines = 1;
+
+    Forced = Limits -> Soft > 0 && Moves.Count == 1;
+
+    Ctx -> Pos = *Pos;
+    PositionTrimHistory(&Ctx -> Pos, CHESS_MAX_HISTORY - SEARCH_MAX_PLY);
+    Ctx -> Limits = *Limits;
+    Ctx -> Start = Now();
+    Ctx -> Nodes = 0;
+    Ctx -> Probes = 0;
+    Ctx -> Hits = 0;
+    Ctx -> Cutoffs = 0;
+    Ctx -> FirstCutoffs = 0;
+    memset(Ctx -> Killers, 0, sizeof(Ctx -> Killers));
+    memset(Ctx -> History, 0, sizeof(Ctx -> History));
+    memset(Ctx -> Counters, 0, sizeof(Ctx -> Counters));
+    Ctx -> Stop = EMBERS_FALSE;
+    Ctx -> LastPVLength = 0;
+
+    Result -> Best = CHESS_NO_MOVE;
+    Result -> Score = 0;
+    Result -> Depth = 0;
+    Result -> PVLength = 0;
+    Result -> LineCount = 0;
+
+    for (int Depth = 1; Depth <= MaxDepth; Depth++) {
+        if (SkipDepth(Ctx -> Id, Depth))
+            continue;
+
+        Mates = 0;
+        for (int i = 0; i < Lines; i++) {
+            Line = &Ctx -> Lines[i];
+            Ctx -> ExcludedCount = i;
+            Line -> Score = Aspiration(Ctx,
+                                       Depth,
+                                       i < Result -> LineCount ?
+                                       &Result -> Lines[i] : NULL);
+            if (Ctx -> Stop)
+                break;
+
+            Line -> Depth = Depth;
+            Mates += Line -> Score >= EVAL_MATE_BOUND ||
+                     Line -> Score <= -EVAL_MATE_BOUND;
+            Line -> PVLength = Ctx -> PVLength[0];
+            for (int j = 0; j < Line -> PVLength; j++)
+                Line -> PV[j] = Ctx -> PV[0][j];
+
+            Ctx -> Excluded[i] = Line -> PVLength ? MoveBase(Line -> PV[0]) :
+                                                    CHESS_NO_MOVE;
+        }
+
+        /* A cut short iteration is thrown away.                              */
+        if (Ctx -> Stop)
+            break;
+
+        /* A later pass can still beat an earlier one once searched deeper.   */
+        for (int i = 1; i < Lines; i++) {
+            for (int j = i; j && Ctx -> Lines[j].Score >
+                                 Ctx -> Lines[j - 1].Score; j--) {
+                Swap = Ctx -> Lines[j];
+                Ctx -> Lines[j] = Ctx -> Lines[j - 1];
+                Ctx -> Lines[j - 1] = Swap;
+            }
+        }
+
+        for (int i = 0; i < Lines; i++)
+            Result -> Lines[i] = Ctx -> Lines[i];
+
+        Result -> LineCount = Lines;
+        Result -> Score = Result -> Lines[0].Score;
+        Result -> Depth = Depth;
+        Result -> PVLength = Result -> Lines[0].PVLength;
+        for (int i = 0; i < Result -> PVLength; i++)
+            Result -> PV[i] = Result -> Lines[0].PV[i];
+
+        Previous = Result -> Best;
+        Result -> Best = Result -> PVLength ? Result -> PV[0] : CHESS_NO_MOVE;
+
+        Instability /= 2;
+        if (Previous != CHESS_NO_MOVE &&
+                MoveBase(Previous) != MoveBase(Result -> Best)) {
+            Instability++;
+            Stable = 0;
+        } else {
+            Stable++;
+        }
+
+        if (Ctx -> Report) {
+            Statistics(Ctx, Result);
+            Ctx -> Report(Result);
+        }
+
+        /* Nothing to search, or a forced mate was found on every line. One   */
+        /* mate alone still leaves the other lines to be searched deeper.     */
+        if (!Result -> PVLength || Mates == Lines)
+            break;
+
+        /* Past the soft limit no iteration is started, the hard one is left  */
+        /* to Poll.                                                           */
+        if (Limits -> Soft > 0 && !Pondering(Ctx) && (Forced ||
+                Now() - Ctx -> Start >=
+                Limits -> Soft * TimeScale(Instability, Stable)))
+            break;
+    }
+
+    Ctx -> ExcludedCount = 0;
+    Statistics(Ctx, Result);
+}
+
+void *HelperThread(void *Data)
+{
+    SearchHelper *Helper = (SearchHelper*)Data;
+
+    SearchRun(Helper -> Ctx,
+              Helper -> Pos,
+              Helper -> Limits,
+              &Helper -> Result);
+    return NULL;
+}
+
+void SearchParallel(SearchContext *Contexts,
+                    int Threads,
+                    const ChessPosition *Pos,
+                    const SearchLimits *Limits,
+                    SearchResult *Result)
+{
+    SearchHelper Helpers[SEARCH_MAX_THREADS];
+    SearchLimits HelperLimits = {Limits -> Depth, 0, 0, NULL};
+    int Stop = EMBERS_FALSE, Started = 0;
+
+    if (Threads > SEARCH_MAX_THREADS)
+        Threads = SEARCH_MAX_THREADS;
+
+    if (Contexts[0].Table)
+        TTNewSearch(Contexts[0].Table);
+
+    /* Helpers have no limits of their own, the main thread ends them.        */
+    HelperLimits.Stop = &Stop;
+    for (int i = 1; i < Threads; i++) {
+        SearchHelper *Helper = &Helpers[Started];
+
+        Contexts[i].Table = Contexts[0].Table;
+        Contexts[i].Pruning = Contexts[0].Pruning;
+        Contexts[i].MultiPV = Contexts[0].MultiPV;
+        Contexts[i].Report = NULL;
+        Contexts[i].Id = i;
+        Helper -> Ctx = &Contexts[i];
+        Helper -> Pos = Pos;
+        Helper -> Limits = &HelperLimits;
+
+        /* Fewer threads only make the search slower.                         */
+        if (!pthread_create(&Helper -> Thread, NULL, HelperThread, Helper))
+            Started++;
+    }
+
+    Contexts[0].Id = 0;
+    SearchRun(&Contexts[0], Pos, Limits, Result);
+    __atomic_store_n(&Stop, EMBERS_TRUE, __ATOMIC_RELAXED);
+
+    for (int i = 0; i < Started; i++) {
+        pthread_join(Helpers[i].Thread, NULL);
+        Result -> Nodes += Helpers[i].Result.Nodes;
+        Result -> Probes += Helpers[i].Result.Probes;
+        Result -> Hits += Helpers[i].Result.Hits;
+        Result -> Cutoffs += Helpers[i].Result.Cutoffs;
+        Result -> FirstCutoffs += Helpers[i].Result.FirstCutoffs;
+    }
+}
+
+double SearchNPS(const SearchResult *Result)
+{
+    return Result -> Seconds > 0 ? Result -> Nodes / Result -> Seconds : 0;
+}
+
+double SearchHitRate(const SearchResult *Result)
+{
+    return Result -> Probes ? (double)Result -> Hits / Result -> Probes : 0;
+}
+
+double SearchCutoffRate(const SearchResult *Result)
+{
+    return Result -> Cutoffs ?
+           (double)Result -> FirstCutoffs / Result -> Cutoffs : 0;
+}
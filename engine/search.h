@@ -0,0 +1,247 @@
+/******************************************************************************\
+*  search.h                                                                    *
+*                                                                              *
+*  Negamax principal variation search, iterative deepening with aspiration     *
+*  windows. Every bit of state lives in a caller owned SearchContext, so       *
+*  searches on different contexts can run at the same time and nothing is      *
+*  allocated while searching.                                                  *
+*  Contexts sharing one transposition table make a Lazy SMP search, helper     *
+*  threads fill the table for the main one.                                    *
+*                                                                              *
+*              Written by Abed Na'ran                          October 2026    *
+*                                                                              *
+\******************************************************************************/
+#ifndef SEARCH_H
+#define SEARCH_H
+#include "position.h"
+#include "tt.h"
+
+/* The deepest the search goes, iterations included.                          */
+#define SEARCH_MAX_PLY (64)
+
+/* Nodes between clock reads.                                                 */
+#define SEARCH_POLL_NODES (1024)
+
+/* The selective search techniques, each can be turned off on its own.        */
+enum {
+    SEARCH_NULL_MOVE = 0x1, /* Pass and see if the opponent still can't cope. */
+    SEARCH_LMR = 0x2, /* Search late quiet moves shallower first.             */
+    SEARCH_FUTILITY = 0x4, /* Skip quiets that can't reach alpha near leaves. */
+    SEARCH_REVERSE_FUTILITY = 0x8, /* Cut when far above beta near leaves.    */
+    SEARCH_PVS = 0x10, /* Prove moves after the first fail low, null window.  */
+    SEARCH_ASPIRATION = 0x20, /* Aim each iteration at the last score.        */
+    SEARCH_PRUNE_ALL = 0x3f
+};
+
+/* The first aspiration window is this far either side of the last score,     */
+/* doubling every time the score falls outside.                               */
+#define SEARCH_ASPIRATION_WINDOW (25)
+
+/* Shallower iterations are too unstable to aim at.                           */
+#define SEARCH_ASPIRATION_DEPTH (4)
+
+/* History scores stay within this either way, so they fit a move's key.      */
+#define SEARCH_HISTORY_MAX (16384)
+
+/* The most root moves a multi-PV search gives lines for.                     */
+#define SEARCH_MAX_LINES (8)
+
+/* The most threads SearchParallel will use.                                  */
+#define SEARCH_MAX_THREADS (64)
+
+/* What ends a search, whichever runs out first. Zero means no limit.         */
+typedef struct SearchLimits {
+    int Depth;
+    unsigned long long Nodes;
+    double Seconds;
+    const int *Stop; /* Set from another thread to end the search, or NULL.   */
+
+    /* No iteration is started past this, in seconds, once TimeScale has      */
+    /* stretched or cut it. Seconds is then the hard limit.                   */
+    double Soft;
+
+    /* While set from another thread the time limits wait, the search is      */
+    /* pondering. They still count from the search's start, so the time       */
+    /* spent pondering is charged once it's cleared. May be NULL.             */
+    const int *Ponder;
+} SearchLimits;
+
+/* One root move's score and the line that follows it.                        */
+typedef struct SearchLine {
+    int Score;
+    int Depth; /* The iteration the line was last searched to.                */
+    ChessMove PV[SEARCH_MAX_PLY];
+    int PVLength;
+} SearchLine;
+
+typedef struct SearchResult {
+    ChessMove Best; /* CHESS_NO_MOVE if there are no legal moves.             */
+    int Score; /* For the side to move, see EVAL_MATE for mates.              */
+    int Depth; /* The last iteration that finished.                           */
+    ChessMove PV[SEARCH_MAX_PLY];
+    int PVLength;
+    unsigned long long Nodes;
+    unsigned long long Probes; /* Transposition table lookups.                */
+    unsigned long long Hits; /* Lookups that found the position.              */
+    int Fill; /* Table entries per thousand written by this search.           */
+    unsigned long long Cutoffs; /* Beta cutoffs, quiescence left out.         */
+    unsigned long long FirstCutoffs; /* Cutoffs by the first move tried.      */
+    double Seconds;
+
+    /* The best root moves, best first, Lines[0] is Score and PV again.       */
+    SearchLine Lines[SEARCH_MAX_LINES];
+    int LineCount;
+} SearchResult;
+
+typedef struct SearchContext {
+    /* Set by the caller and kept across searches.                            */
+    TTable *Table; /* The transposition table, or NULL for none.              */
+    int Id; /* 0 for the main thread, helpers skip staggered depths.          */
+    int Pruning; /* The SEARCH_* techniques turned on.                        */
+    int MultiPV; /* Root moves to give lines for, 0 or 1 for the best only.   */
+
+    /* Given the result so far after every finished iteration, may be NULL.   */
+    void (*Report)(const SearchResult *Result);
+
+    ChessPosition Pos; /* A copy of the root, searched in place.              */
+    SearchLimits Limits;
+    double Start;
+    unsigned long long Nodes;
+    unsigned long long Probes;
+    unsigned long long Hits;
+    unsigned long long Cutoffs;
+    unsigned long long FirstCutoffs;
+    EMBERS_BOOL Stop;
+
+    /* Triangular PV table, row Ply holds the line found from Ply on.         */
+    ChessMove PV[SEARCH_MAX_PLY][SEARCH_MAX_PLY];
+    int PVLength[SEARCH_MAX_PLY];
+
+    /* The previous iteration's line, tried first while the search follows    */
+    /* it.                                                                    */
+    ChessMove LastPV[SEARCH_MAX_PLY];
+    int LastPVLength;
+    EMBERS_BOOL FollowPV;
+
+    /* The lines of the iteration under way, their moves are left out at the  */
+    /* root so each pass finds the next best.                                 */
+    SearchLine Lines[SEARCH_MAX_LINES];
+    ChessMove Excluded[SEARCH_MAX_LINES];
+    int ExcludedCount;
+
+    /* Quiet moves that cut off before, cleared by every search. Killers are  */
+    /* kept by ply, history by side, from and to, and counter moves by the    */
+    /* from and to of the move they answer.                                   */
+    ChessMove Killers[SEARCH_MAX_PLY][2];
+    int History[2][64][64];
+    ChessMove Counters[64][64];
+} SearchContext;
+
+/******************************************************************************\
+* SearchRun                                                                    *
+*                                                                              *
+*  Search a position by iterative deepening until a limit is hit. Only whole   *
+*  iterations count, but depth 1 always finishes so a legal move is returned   *
+*  whenever there is one. Iterations after the first few start on a narrow     *
+*  window around the last score and widen it when the score falls outside.     *
+*  With MultiPV above 1 each iteration searches the root once per line, each   *
+*  pass leaving out the moves found before it. A soft limit ends the search    *
+*  between iterations, early when the best move holds or there is only one,    *
+*  late when the best move keeps changing.                                     *
+*                                                                              *
+* Parameters                                                                   *
+*                                                                              *
+*  -Ctx: The context, all but the fields the caller sets is overwritten.       *
+*  -Pos: The position to search, not changed.                                  *
+*  -Limits: When to stop.                                                      *
+*  -Result: Out, the best move, its line and the search statistics.            *
+*                                                                              *
+* Return                                                                       *
+*                                                                              *
+*  -void.                                                                      *
+*                                                                              *
+\******************************************************************************/
+void SearchRun(SearchContext *Ctx,
+               const ChessPosition *Pos,
+               const SearchLimits *Limits,
+               SearchResult *Result);
+
+/******************************************************************************\
+* SearchParallel                                                               *
+*                                                                              *
+*  Search a position with Lazy SMP. Contexts[0] searches as SearchRun would    *
+*  while the others search the same root on their own threads, at staggered    *
+*  depths, sharing its transposition table. The helpers are stopped once the   *
+*  main search ends and only its result is returned. Entries left in the       *
+*  table by earlier searches are aged first. Only Contexts[0] reports its      *
+*  iterations.                                                                 *
+*                                                                              *
+* Parameters                                                                   *
+*                                                                              *
+*  -Contexts: Threads contexts, given Contexts[0]'s Table, Pruning, MultiPV.   *
+*  -Threads: The number of threads, 1 to SEARCH_MAX_THREADS.                   *
+*  -Pos: The position to search, not changed.                                  *
+*  -Limits: When to stop, the node limit counts the main thread only.          *
+*  -Result: Out, as SearchRun, with the counts summed over every thread.       *
+*                                                                              *
+* Return                                                                       *
+*                                                                              *
+*  -void.                                                                      *
+*                                                                              *
+\******************************************************************************/
+void SearchParallel(SearchContext *Contexts,
+                    int Threads,
+                    const ChessPosition *Pos,
+                    const SearchLimits *Limits,
+                    SearchResult *Result);
+
+/******************************************************************************\
+* SearchNPS                                                                    *
+*                                                                              *
+*  The throughput of a finished search.                                        *
+*                                                                              *
+* Parameters                                                                   *
+*                                                                              *
+*  -Result: The result.                                                        *
+*                                                                              *
+* Return                                                                       *
+*                                                                              *
+*  -double: Nodes per second.                                                  *
+*                                                                              *
+\******************************************************************************/
+double SearchNPS(const SearchResult *Result);
+
+/******************************************************************************\
+* SearchHitRate                                                                *
+*                                                                              *
+*  How often a finished search found a position in its transposition table.    *
+*                                                                              *
+* Parameters                                                                   *
+*                                                                              *
+*  -Result: The result.                                                        *
+*                                                                              *
+* Return                                                                       *
+*                                                                              *
+*  -double: Hits per probe, 0 to 1.                                            *
+*                                                                              *
+\******************************************************************************/
+double SearchHitRate(const SearchResult *Result);
+
+/******************************************************************************\
+* SearchCutoffRate                                                             *
+*                                                                              *
+*  How often a finished search's cutoffs came from the first move tried, the   *
+*  measure of how well it orders moves.                                        *
+*                                                                              *
+* Parameters                                                                   *
+*                                                                              *
+*  -Result: The result.                                                        *
+*                                                                              *
+* Return                                                                       *
+*                                                                              *
+*  -double: First move cutoffs per cutoff, 0 to 1.                             *
+*                                                                              *
+\******************************************************************************/
+double SearchCutoffRate(const SearchResult *Result);
+
+#endif /* SEARCH_H */
@@ -0,0 +1,91 @@
+#include "see.h"
+#include "movegen.h"
+#include "moves.h"
+
+/* The longest exchange, every piece on the board taking in turn.             */
+#define SEE_MAX_SWAPS (32)
+
+static inline int Value(int Type);
+
+/* MovesValues, with a king worth more than anything it could win so it never */
+/* takes a defended piece.                                                    */
+int Value(int Type)
+{
+    return Type == CHESS_KING ? 20000 : MovesValues[Type];
+}
+
+int SeeMove(const ChessPosition *Pos, ChessMove Move)
+{
+    int From = MoveFrom(Move),
+        To = MoveTo(Move),
+        Flags = MoveFlags(Move),
+        Side = Pos -> SideToMove,
+        Gain[SEE_MAX_SWAPS],
+        Swaps = 0,
+        OnSquare;
+    Bitboard Occ = Pos -> Occupancy[CHESS_BOTH],
+             Diagonal = Pos -> Pieces[CHESS_WHITE][CHESS_BISHOP] |
+                        Pos -> Pieces[CHESS_BLACK][CHESS_BISHOP] |
+                        Pos -> Pieces[CHESS_WHITE][CHESS_QUEEN] |
+                        Pos -> Pieces[CHESS_BLACK][CHESS_QUEEN],
+             Straight = Pos -> Pieces[CHESS_WHITE][CHESS_ROOK] |
+                        Pos -> Pieces[CHESS_BLACK][CHESS_ROOK] |
+                        Pos -> Pieces[CHESS_WHITE][CHESS_QUEEN] |
+                        Pos -> Pieces[CHESS_BLACK][CHESS_QUEEN],
+             Next = BITBOARD_SQUARE(From),
+             Attackers, Set;
+
+    if (Flags == CHESS_MOVE_CASTLE_KING || Flags == CHESS_MOVE_CASTLE_QUEEN)
+        return 0;
+
+    /* Gain[i] is what the side making capture i has won if it's the last,    */
+    /* the piece left on the square is worth OnSquare.                        */
+    Gain[0] = 0;
+    OnSquare = Value(CHESS_PIECE_TYPE(Pos -> Squares[From]));
+    if (Flags == CHESS_MOVE_EN_PASSANT) {
+        Gain[0] = MovesValues[CHESS_PAWN];
+        Occ ^= BITBOARD_SQUARE(To + (Side == CHESS_WHITE ? -8 : 8));
+    } else if (Flags & CHESS_MOVE_CAPTURE) {
+        Gain[0] = Value(CHESS_PIECE_TYPE(Pos -> Squares[To]));
+    }
+
+    if (MoveIsPromotion(Move)) {
+        OnSquare = MovesValues[MovePromotionType(Move)];
+        Gain[0] += OnSquare - MovesValues[CHESS_PAWN];
+    }
+
+    Attackers = MoveGenAttackersTo(Pos, To, Occ);
+    do {
+        Swaps++;
+        Gain[Swaps] = OnSquare - Gain[Swaps - 1];
+
+        /* Neither side would go on, whatever follows changes nothing.        */
+        if (-Gain[Swaps - 1] < 0 && Gain[Swaps] < 0)
+            break;
+
+        /* Sliders behind the piece that just took join in.                   */
+        Occ ^= Next;
+        Attackers |= (AttacksBishop(To, Occ) & Diagonal) |
+                     (AttacksRook(To, Occ) & Straight);
+        Attackers &= Occ;
+
+        /* The other side takes back with its least valuable piece.           */
+        Side ^= 1;
+        Next = 0;
+        for (int Type = CHESS_PAWN; Type >= CHESS_KING; Type--) {
+            if ((Set = Attackers & Pos -> Pieces[Side][Type])) {
+                Next = Set & -Set;
+                OnSquare = Value(Type);
+                break;
+            }
+        }
+    } while (Next && Swaps + 1 < SEE_MAX_SWAPS);
+
+    /* Back up from the last capture, each side takes only when it pays.      */
+    while (--Swaps) {
+        if (-Gain[Swaps] < Gain[Swaps - 1])
+            Gain[Swaps - 1] = -Gain[Swaps];
+    }
+
+    return Gain[0];
+}
@@ -0,0 +1,34 @@
+/******************************************************************************\
+*  see.h                                                                       *
+*                                                                              *
+*  Static exchange evaluation. The captures on one square are played out on    *
+*  attack sets alone, least valuable attacker first, so a move's material      *
+*  outcome is known without making it.                                         *
+*                                                                              *
+*              Written by Abed Na'ran                          October 2026    *
+*                                                                              *
+\******************************************************************************/
+#ifndef SEE_H
+#define SEE_H
+#include "position.h"
+
+/******************************************************************************\
+* SeeMove                                                                      *
+*                                                                              *
+*  Work out what a move wins once every capture back and forth on its          *
+*  destination is played, either side stopping when going on would lose.       *
+*  X-rays through the capturing pieces are seen, pins are not.                 *
+*                                                                              *
+* Parameters                                                                   *
+*                                                                              *
+*  -Pos: The position.                                                         *
+*  -Move: A legal move for the side to move.                                   *
+*                                                                              *
+* Return                                                                       *
+*                                                                              *
+*  -int: The material won in centipawns, negative when the move loses.         *
+*                                                                              *
+\******************************************************************************/
+int SeeMove(const ChessPosition *Pos, ChessMove Move);
+
+#endif /* SEE_H */
@@ -0,0 +1,34 @@
+#include "timeman.h"
+
+/* Zero would mean no limit at all, a clock that has run out moves at once.   */
+#define TIME_MINIMUM (0.001)
+
+void TimeAllocate(const TimeControl *Clock, SearchLimits *Limits)
+{
+    int MovesToGo = Clock -> MovesToGo > 0 ? Clock -> MovesToGo :
+                                             TIME_MOVES_LEFT;
+    double Left = Clock -> Remaining - TIME_OVERHEAD, Soft, Hard, Cap;
+
+    if (Left < TIME_MINIMUM)
+        Left = TIME_MINIMUM;
+
+    /* Every move to go but this one brings an increment back.                */
+    Soft = (Left + Clock -> Increment * (MovesToGo - 1)) / MovesToGo;
+
+    /* Half the clock at most while there are moves left to play on it.       */
+    Cap = MovesToGo > 1 ? Left / 2 : Left;
+    Hard = Soft * TIME_HARD_FACTOR < Cap ? Soft * TIME_HARD_FACTOR : Cap;
+
+    Limits -> Seconds = Hard;
+    Limits -> Soft = Soft < Hard ? Soft : Hard;
+}
+
+double TimeScale(double Instability, int Stable)
+{
+    double Scale = 1 + (Instability < 2 ? Instability : 2) / 2;
+
+    if (Stable >= TIME_STABLE_ITERATIONS)
+        Scale /= 2;
+
+    return Scale;
+}
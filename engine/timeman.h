@@ -0,0 +1,72 @@
+/******************************************************************************\
+*  timeman.h                                                                   *
+*                                                                              *
+*  Time management, turning what is left on a chess clock into how long to     *
+*  think about one move. A soft limit decides whether another iteration is     *
+*  started, a hard one stops the search wherever it is.                        *
+*                                                                              *
+*              Written by Abed Na'ran                          October 2026    *
+*                                                                              *
+\******************************************************************************/
+#ifndef TIMEMAN_H
+#define TIMEMAN_H
+#include "search.h"
+
+/* Moves the rest of the game is assumed to take under sudden death.          */
+#define TIME_MOVES_LEFT (30)
+
+/* Kept back from every move for the time lost outside the search, seconds.   */
+#define TIME_OVERHEAD (0.05)
+
+/* How far past the soft limit the hard one lies.                             */
+#define TIME_HARD_FACTOR (4)
+
+/* Iterations the best move has to hold before the soft limit is shortened.   */
+#define TIME_STABLE_ITERATIONS (4)
+
+/* The side to move's clock.                                                  */
+typedef struct TimeControl {
+    double Remaining; /* Seconds left.                                        */
+    double Increment; /* Seconds added after every move.                      */
+    int MovesToGo; /* Until the next time control, 0 for sudden death.        */
+} TimeControl;
+
+/******************************************************************************\
+* TimeAllocate                                                                 *
+*                                                                              *
+*  Share the time left out between the moves to go, counting in the            *
+*  increments still to come. The hard limit never spends more than what is     *
+*  left on the clock bar the overhead.                                         *
+*                                                                              *
+* Parameters                                                                   *
+*                                                                              *
+*  -Clock: The side to move's clock.                                           *
+*  -Limits: Out, its Seconds and Soft are set, the rest is left alone.         *
+*                                                                              *
+* Return                                                                       *
+*                                                                              *
+*  -void.                                                                      *
+*                                                                              *
+\******************************************************************************/
+void TimeAllocate(const TimeControl *Clock, SearchLimits *Limits);
+
+/******************************************************************************\
+* TimeScale                                                                    *
+*                                                                              *
+*  How much of the soft limit to use given how the best move has behaved.      *
+*  A best move that keeps changing is given longer, one that has held for      *
+*  TIME_STABLE_ITERATIONS iterations dominates and the move is cut short.      *
+*                                                                              *
+* Parameters                                                                   *
+*                                                                              *
+*  -Instability: Recent best move changes, halved every iteration.             *
+*  -Stable: Iterations in a row the best move has stayed the same.             *
+*                                                                              *
+* Return                                                                       *
+*                                                                              *
+*  -double: The factor to multiply the soft limit by.                          *
+*                                                                              *
+\******************************************************************************/
+double TimeScale(double Instability, int Stable);
+
+#endif /* TIMEMAN_H */
@@ -0,0 +1,197 @@
+#include "tt.h"
+#include <string.h>
+#include <sys/mman.h>
+
+/* The size of a huge page, what a huge page mapping is rounded to.           */
+#define TT_HUGE_PAGE (2 << 20)
+
+static inline uint64_t TTPack(ChessMove Move,
+                              int Score,
+                              int Depth,
+                              int Bound,
+                              int Generation);
+static inline int TTDepth(uint64_t Data);
+static inline int TTGeneration(uint64_t Data);
+
+/* The move in bits 0-15, the score in 16-31, the depth in 32-39, the bound   */
+/* in 40-41 and the generation in 42-47. Stored data is never zero, an empty  */
+/* slot is.                                                                   */
+uint64_t TTPack(ChessMove Move, int Score, int Depth, int Bound, int Generation)
+{
+    return (uint64_t)MoveBase(Move) |
+           ((uint64_t)(uint16_t)Score << 16) |
+           ((uint64_t)(Depth & 0xff) << 32) |
+           ((uint64_t)Bound << 40) |
+           ((uint64_t)Generation << 42);
+}
+
+int TTDepth(uint64_t Data)
+{
+    return (Data >> 32) & 0xff;
+}
+
+int TTGeneration(uint64_t Data)
+{
+    return (Data >> 42) & (TT_GENERATIONS - 1);
+}
+
+EMBERS_BOOL TTCreate(TTable *Table, size_t Megabytes)
+{
+    size_t Count = 1;
+    void *Memory;
+
+    while (Count * 2 * sizeof(TTBucket) <= Megabytes << 20)
+        Count *= 2;
+
+    Table -> Bytes = Count * sizeof(TTBucket);
+    Table -> Mask = Count - 1;
+    Table -> Generation = 0;
+    Table -> HugePages = EMBERS_FALSE;
+
+    /* Reserved huge pages first, then ordinary pages the kernel may back     */
+    /* with transparent huge pages. Either way the memory comes zeroed.       */
+    Memory = MAP_FAILED;
+#ifdef MAP_HUGETLB
+    if (!(Table -> Bytes % TT_HUGE_PAGE))
+        Memory = mmap(NULL,
+                      Table -> Bytes,
+                      PROT_READ | PROT_WRITE,
+                      MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB,
+                      -1,
+                      0);
+#endif
+
+    if (Memory != MAP_FAILED) {
+        Table -> HugePages = EMBERS_TRUE;
+    } else {
+        Memory = mmap(NULL,
+                      Table -> Bytes,
+                      PROT_READ | PROT_WRITE,
+                      MAP_PRIVATE | MAP_ANONYMOUS,
+                      -1,
+                      0);
+        if (Memory == MAP_FAILED) {
+            Table -> Buckets = NULL;
+            return EMBERS_FALSE;
+        }
+
+#ifdef MADV_HUGEPAGE
+        Table -> HugePages = !madvise(Memory, Table -> Bytes, MADV_HUGEPAGE);
+#endif
+    }
+
+    Table -> Buckets = (TTBucket*)Memory;
+    return EMBERS_TRUE;
+}
+
+void TTFree(TTable *Table)
+{
+    if (Table -> Buckets)
+        munmap(Table -> Buckets, Table -> Bytes);
+
+    Table -> Buckets = NULL;
+}
+
+void TTClear(TTable *Table)
+{
+    memset(Table -> Buckets, 0, Table -> Bytes);
+    Table -> Generation = 0;
+}
+
+void TTNewSearch(TTable *Table)
+{
+    Table -> Generation = (Table -> Generation + 1) & (TT_GENERATIONS - 1);
+}
+
+EMBERS_BOOL TTProbe(const TTable *Table, ChessKey Key, TTHit *Hit)
+{
+    const TTEntry *Entry = Table -> Buckets[Key & Table -> Mask].Entries;
+    uint64_t Data;
+
+    for (int i = 0; i < TT_BUCKET_ENTRIES; i++, Entry++) {
+        Data = __atomic_load_n(&Entry -> Data, __ATOMIC_RELAXED);
+        if ((__atomic_load_n(&Entry -> Key, __ATOMIC_RELAXED) ^ Data) != Key ||
+                !Data)
+            continue;
+
+        Hit -> Move = Data & 0xffff;
+        Hit -> Score = (int16_t)(Data >> 16);
+        Hit -> Depth = TTDepth(Data);
+        Hit -> Bound = (Data >> 40) & 0x03;
+        return EMBERS_TRUE;
+    }
+
+    return EMBERS_FALSE;
+}
+
+void TTStore(TTable *Table,
+             ChessKey Key,
+             ChessMove Move,
+             int Score,
+             int Depth,
+             int Bound)
+{
+    TTEntry *Entry = Table -> Buckets[Key & Table -> Mask].Entries,
+            *Victim = NULL;
+    uint64_t Data;
+    int Worth, Lowest = 0;
+
+    for (int i = 0; i < TT_BUCKET_ENTRIES; i++, Entry++) {
+        Data = __atomic_load_n(&Entry -> Data, __ATOMIC_RELAXED);
+
+        if ((__atomic_load_n(&Entry -> Key, __ATOMIC_RELAXED) ^ Data) == Key &&
+                Data) {
+            if (Move == CHESS_NO_MOVE)
+                Move = Data & 0xffff;
+
+            /* A deeper bound from this search outlasts a shallower one, only */
+            /* its move is brought up to date.                                */
+            if (TTGeneration(Data) == Table -> Generation &&
+                    TTDepth(Data) > Depth && Bound != TT_EXACT) {
+                if (MoveBase(Move) == (Data & 0xffff))
+                    return;
+
+                Depth = TTDepth(Data);
+                Score = (int16_t)(Data >> 16);
+                Bound = (Data >> 40) & 0x03;
+            }
+
+            Victim = Entry;
+            break;
+        }
+
+        /* Every generation of age costs as much as eight plies of depth, an  */
+        /* empty slot is worth nothing at all.                                */
+        Worth = Data ? TTDepth(Data) + 1 -
+                       8 * ((Table -> Generation - TTGeneration(Data)) &
+                            (TT_GENERATIONS - 1)) :
+                       -8 * TT_GENERATIONS;
+        if (!Victim || Worth < Lowest) {
+            Victim = Entry;
+            Lowest = Worth;
+        }
+    }
+
+    Data = TTPack(Move, Score, Depth, Bound, Table -> Generation);
+    __atomic_store_n(&Victim -> Key, Key ^ Data, __ATOMIC_RELAXED);
+    __atomic_store_n(&Victim -> Data, Data, __ATOMIC_RELAXED);
+}
+
+int TTFill(const TTable *Table)
+{
+    int Used = 0, Buckets = 1000 / TT_BUCKET_ENTRIES;
+    uint64_t Data;
+
+    if ((size_t)Buckets > Table -> Mask + 1)
+        Buckets = (int)Table -> Mask + 1;
+
+    for (int i = 0; i < Buckets; i++) {
+        for (int j = 0; j < TT_BUCKET_ENTRIES; j++) {
+            Data = __atomic_load_n(&Table -> Buckets[i].Entries[j].Data,
+                                   __ATOMIC_RELAXED);
+            Used += Data && TTGeneration(Data) == Table -> Generation;
+        }
+    }
+
+    return Used * 1000 / (Buckets * TT_BUCKET_ENTRIES);
+}
@@ -0,0 +1,191 @@
+/******************************************************************************\
+*  tt.h                                                                        *
+*                                                                              *
+*  The transposition table, shared by every search thread without locks.       *
+*  A slot is two 64-bit words, the data and the key XOR the data, so a slot    *
+*  torn by two writers fails the key check and is never trusted. Slots come    *
+*  four to a cache line bucket, a probe touches one line.                      *
+*                                                                              *
+*              Written by Abed Na'ran                          October 2026    *
+*                                                                              *
+\******************************************************************************/
+#ifndef TT_H
+#define TT_H
+#include "position.h"
+#include <stddef.h>
+
+/* What a stored score says about the real one.                               */
+enum {
+    TT_NONE = 0,
+    TT_UPPER, /* The real score is at most this, no move beat alpha.          */
+    TT_LOWER, /* The real score is at least this, a move hit beta.            */
+    TT_EXACT
+};
+
+#define TT_BUCKET_ENTRIES (4)
+
+/* Generations wrap, an entry this many searches old looks new again.         */
+#define TT_GENERATIONS (64)
+
+typedef struct TTEntry {
+    ChessKey Key; /* The position key XOR Data.                               */
+    uint64_t Data; /* Move, score, depth, bound and generation, see TTPack.   */
+} TTEntry;
+
+typedef struct alignas(64) TTBucket {
+    TTEntry Entries[TT_BUCKET_ENTRIES];
+} TTBucket;
+
+typedef struct TTable {
+    TTBucket *Buckets;
+    size_t Mask; /* Bucket count minus one, the count is a power of two.      */
+    size_t Bytes; /* What was mapped.                                         */
+    EMBERS_BOOL HugePages; /* Whether the kernel was asked for huge pages.    */
+    int Generation; /* Bumped by TTNewSearch, stamped on every store.         */
+} TTable;
+
+/* A probed entry unpacked.                                                   */
+typedef struct TTHit {
+    ChessMove Move;
+    int Score;
+    int Depth;
+    int Bound;
+} TTHit;
+
+/******************************************************************************\
+* TTCreate                                                                     *
+*                                                                              *
+*  Allocate an empty table, on huge pages when the system has them.            *
+*                                                                              *
+* Parameters                                                                   *
+*                                                                              *
+*  -Table: The table.                                                          *
+*  -Megabytes: The most memory to use, rounded down to a power of two.         *
+*                                                                              *
+* Return                                                                       *
+*                                                                              *
+*  -EMBERS_BOOL: EMBERS_FALSE if out of memory.                                *
+*                                                                              *
+\******************************************************************************/
+EMBERS_BOOL TTCreate(TTable *Table, size_t Megabytes);
+
+/******************************************************************************\
+* TTFree                                                                       *
+*                                                                              *
+*  Free a table made by TTCreate.                                              *
+*                                                                              *
+* Parameters                                                                   *
+*                                                                              *
+*  -Table: The table.                                                          *
+*                                                                              *
+* Return                                                                       *
+*                                                                              *
+*  -void.                                                                      *
+*                                                                              *
+\******************************************************************************/
+void TTFree(TTable *Table);
+
+/******************************************************************************\
+* TTClear                                                                      *
+*                                                                              *
+*  Forget every entry, no search may be using the table.                       *
+*                                                                              *
+* Parameters                                                                   *
+*                                                                              *
+*  -Table: The table.                                                          *
+*                                                                              *
+* Return                                                                       *
+*                                                                              *
+*  -void.                                                                      *
+*                                                                              *
+\******************************************************************************/
+void TTClear(TTable *Table);
+
+/******************************************************************************\
+* TTNewSearch                                                                  *
+*                                                                              *
+*  Start a new generation, entries from earlier searches age and become the    *
+*  first to be replaced. No search may be using the table.                     *
+*                                                                              *
+* Parameters                                                                   *
+*                                                                              *
+*  -Table: The table.                                                          *
+*                                                                              *
+* Return                                                                       *
+*                                                                              *
+*  -void.                                                                      *
+*                                                                              *
+\******************************************************************************/
+void TTNewSearch(TTable *Table);
+
+/******************************************************************************\
+* TTProbe                                                                      *
+*                                                                              *
+*  Look a position up.                                                         *
+*                                                                              *
+* Parameters                                                                   *
+*                                                                              *
+*  -Table: The table.                                                          *
+*  -Key: The position key.                                                     *
+*  -Hit: Out, the entry when found.                                            *
+*                                                                              *
+* Return                                                                       *
+*                                                                              *
+*  -EMBERS_BOOL: EMBERS_TRUE if the position was found.                        *
+*                                                                              *
+\******************************************************************************/
+EMBERS_BOOL TTProbe(const TTable *Table, ChessKey Key, TTHit *Hit);
+
+/******************************************************************************\
+* TTStore                                                                      *
+*                                                                              *
+*  Store a search result. An entry for the same position is overwritten,       *
+*  unless it's from this search, deeper, and the new bound isn't exact, then   *
+*  only its move is. Otherwise the bucket's shallowest entry, counting older   *
+*  generations as shallower, makes room.                                       *
+*                                                                              *
+* Parameters                                                                   *
+*                                                                              *
+*  -Table: The table.                                                          *
+*  -Key: The position key.                                                     *
+*  -Move: The best move or CHESS_NO_MOVE to keep the stored one.               *
+*  -Score: The score, mates adjusted to be relative to this position.          *
+*  -Depth: The depth searched.                                                 *
+*  -Bound: TT_UPPER, TT_LOWER or TT_EXACT.                                     *
+*                                                                              *
+* Return                                                                       *
+*                                                                              *
+*  -void.                                                                      *
+*                                                                              *
+\******************************************************************************/
+void TTStore(TTable *Table,
+             ChessKey Key,
+             ChessMove Move,
+             int Score,
+             int Depth,
+             int Bound);
+
+/******************************************************************************\
+* TTFill                                                                       *
+*                                                                              *
+*  Estimate how full the table is from its first thousand entries.             *
+*                                                                              *
+* Parameters                                                                   *
+*                                                                              *
+*  -Table: The table.                                                          *
+*                                                                              *
+* Return                                                                       *
+*                                                                              *
+*  -int: Entries per thousand written by the current generation.               *
+*                                                                              *
+\******************************************************************************/
+int TTFill(const TTable *Table);
+
+/* Start loading Key's bucket, issued as soon as a key is known so the line   */
+/* is in cache by the time the node probes it.                                */
+static inline void TTPrefetch(const TTable *Table, ChessKey Key)
+{
+    __builtin_prefetch(&Table -> Buckets[Key & Table -> Mask]);
+}
+
+#endif /* TT_H */
@@ -10,11 +10,9 @@
 #ifndef MOVES_H
 #define MOVES_H
 
-#define CHESS_END_MOVES (0xffff)
-
 /* The pawn is handled differently as it has ALOT more rules.                 */
 
-static char 
+inline constexpr char
     MovesSizes[5] =
         {
             8, /* King.                                                       */
@@ -24,7 +22,7 @@ static char
             4, /* Bishop.                                                     */
         };
 
-static char
+inline constexpr char
     MovesIterate[5] =
         {
             0, /* King.                                                       */
@@ -34,7 +32,7 @@ static char
             1, /* Bishop.                                                     */
         };
 
-static char
+inline constexpr char
     MovesTemplates[5][8][2] =
         { 
             {{1, 0}, {-1, 0},
@@ -60,4 +58,16 @@ static char
 
         };
 
+/* Material values in centipawns, the king can't be traded so it has none.    */
+inline constexpr short
+    MovesValues[6] =
+        {
+            0, /* King.                                                       */
+            900, /* Queen.                                                    */
+            500, /* Rook.                                                     */
+            320, /* Knight.                                                   */
+            330, /* Bishop.                                                   */
+            100, /* Pawn.                                                     */
+        };
+
 #endif /* MOVES_H */
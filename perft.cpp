@@ -0,0 +1,247 @@
+/******************************************************************************\
+*  perft.cpp                                                                   *
+*                                                                              *
+*  A headless perft runner for the move generator, no window or GL needed.     *
+*  With no arguments it checks the generator against known node counts and     *
+*  exits non zero on a mismatch, otherwise it divides one position.            *
+*                                                                              *
+*      perft [OPTIONS]                 Run the known positions.                *
+*      perft [OPTIONS] DEPTH [FEN]     Divide FEN, the start position by       *
+*                                      default.                                *
+*                                                                              *
+*      -plain      Make every move, the reference mode. Only the shallow       *
+*                  known positions are run.                                    *
+*      -hash MB    Size of the subtree count cache, 0 to turn it off.          *
+*      -threads N  Threads to split the tree across, every core by default.    *
+*                                                                              *
+*              Written by Abed Na'ran                          October 2026    *
+*                                                                              *
+\******************************************************************************/
+#include "config.h"
+#include "movegen.h"
+#include "attacks.h"
+#include "perft.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+#define PERFT_START_FEN \
+    "rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1"
+
+/* The default subtree count cache size in megabytes.                         */
+#define PERFT_HASH_MB (256)
+
+typedef struct PerftCase {
+    const char *Name;
+    const char *FEN;
+    int Depth;
+    unsigned long long Nodes;
+    EMBERS_BOOL Deep; /* Too slow for the plain mode.                         */
+} PerftCase;
+
+#define PERFT_KIWIPETE \
+    "r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 1"
+#define PERFT_POSITION_3 "8/2p5/3p4/KP5r/1R3p1k/8/4P1P1/8 w - - 0 1"
+#define PERFT_POSITION_4 \
+    "r3k2r/Pppp1ppp/1b3nbN/nP6/BBP1P3/q4N2/Pp1P2PP/R2Q1RK1 w kq - 0 1"
+#define PERFT_POSITION_5 \
+    "rnbq1k1r/pp1Pbppp/2p5/8/2B5/8/PPP1NnPP/RNBQK2R w KQ - 1 8"
+#define PERFT_POSITION_6 \
+    "r4rk1/1pp1qppp/p1np1n2/2b1p1B1/2B1P1b1/P1NP1N2/1PP1QPPP/R4RK1 w - - 0 10"
+
+/* The usual positions, between them they hit castling through check, en      */
+/* passant discovered checks and every kind of promotion.                     */
+static const PerftCase PerftCases[] = {
+    {"start", PERFT_START_FEN, 5, 4865609ULL, EMBERS_FALSE},
+    {"kiwipete", PERFT_KIWIPETE, 4, 4085603ULL, EMBERS_FALSE},
+    {"position 3", PERFT_POSITION_3, 6, 11030083ULL, EMBERS_FALSE},
+    {"position 4", PERFT_POSITION_4, 5, 15833292ULL, EMBERS_FALSE},
+    {"position 5", PERFT_POSITION_5, 4, 2103487ULL, EMBERS_FALSE},
+    {"position 6", PERFT_POSITION_6, 4, 3894594ULL, EMBERS_FALSE},
+    {"start", PERFT_START_FEN, 7, 3195901860ULL, EMBERS_TRUE},
+    {"kiwipete", PERFT_KIWIPETE, 5, 193690690ULL, EMBERS_TRUE},
+    {"position 3", PERFT_POSITION_3, 7, 178633661ULL, EMBERS_TRUE},
+    {"position 4", PERFT_POSITION_4, 6, 706045033ULL, EMBERS_TRUE},
+    {"position 5", PERFT_POSITION_5, 5, 89941194ULL, EMBERS_TRUE},
+    {"position 6", PERFT_POSITION_6, 5, 164075551ULL, EMBERS_TRUE},
+};
+
+static ChessPosition Position;
+
+static EMBERS_BOOL Plain = EMBERS_FALSE;
+static PerftTable Table;
+static PerftTable *Hash = NULL;
+static int Threads = 1;
+
+static double Now();
+static unsigned long long Count(int Depth,
+                                MoveList *Moves,
+                                unsigned long long *Counts);
+static void Report(unsigned long long Nodes, double Seconds);
+static int RunCases();
+static int Divide(const char *FEN, int Depth);
+
+double Now()
+{
+    struct timespec Time;
+
+    clock_gettime(CLOCK_MONOTONIC, &Time);
+    return Time.tv_sec + Time.tv_nsec / 1e9;
+}
+
+/* Count the leaf nodes under each root move of Position, Depth >= 1.         */
+unsigned long long Count(int Depth,
+                         MoveList *Moves,
+                         unsigned long long *Counts)
+{
+    unsigned long long Total = 0;
+
+    if (!Plain)
+        return PerftDivide(&Position, Depth, Hash, Threads, Moves, Counts);
+
+    MoveGenLegal(&Position, Moves);
+    for (int i = 0; i < Moves -> Count; i++) {
+        PositionMakeMove(&Position, Moves -> Moves[i]);
+        Counts[i] = MoveGenPerft(&Position, Depth - 1);
+        PositionUnmakeMove(&Position);
+        Total += Counts[i];
+    }
+
+    return Total;
+}
+
+void Report(unsigned long long Nodes, double Seconds)
+{
+    printf("%llu nodes in %.3fs, %.2f Mnps\n",
+           Nodes,
+           Seconds,
+           Seconds > 0 ? Nodes / Seconds / 1e6 : 0.0);
+}
+
+int RunCases()
+{
+    MoveList Moves;
+    unsigned long long Counts[CHESS_MAX_MOVES], Total = 0;
+    int Failed = 0;
+    double Start = Now();
+
+    for (size_t i = 0; i < sizeof(PerftCases) / sizeof(*PerftCases); i++) {
+        const PerftCase *Case = &PerftCases[i];
+        unsigned long long Nodes;
+        double Begin;
+
+        if (Plain && Case -> Deep)
+            continue;
+
+        if (!PositionFromFEN(&Position, Case -> FEN)) {
+            printf("%-12s bad FEN\n", Case -> Name);
+            Failed++;
+            continue;
+        }
+
+        Begin = Now();
+        Nodes = Count(Case -> Depth, &Moves, Counts);
+        Total += Nodes;
+
+        printf("%-12s depth %d %-4s ",
+               Case -> Name,
+               Case -> Depth,
+               Nodes == Case -> Nodes ? "ok" : "FAIL");
+        Report(Nodes, Now() - Begin);
+
+        if (Nodes != Case -> Nodes) {
+            printf("%-12s expected %llu\n", "", Case -> Nodes);
+            Failed++;
+        }
+    }
+
+    printf("total                       ");
+    Report(Total, Now() - Start);
+    return Failed ? EXIT_FAILURE : EXIT_SUCCESS;
+}
+
+int Divide(const char *FEN, int Depth)
+{
+    MoveList Moves;
+    unsigned long long Counts[CHESS_MAX_MOVES], Total;
+    double Start;
+    char Move[CHESS_MOVE_TEXT];
+
+    if (!PositionFromFEN(&Position, FEN)) {
+        fprintf(stderr, "bad FEN: %s\n", FEN);
+        return EXIT_FAILURE;
+    }
+
+    Start = Now();
+    Total = Count(Depth, &Moves, Counts);
+    for (int i = 0; i < Moves.Count; i++) {
+        MoveWrite(Moves.Moves[i], Move);
+        printf("%s: %llu\n", Move, Counts[i]);
+    }
+
+    printf("\n%d moves, ", Moves.Count);
+    Report(Total, Now() - Start);
+    return EXIT_SUCCESS;
+}
+
+int main(int argc, const char *argv[])
+{
+    size_t Megabytes = PERFT_HASH_MB;
+    int Depth, Arg = 1, Status;
+
+    Threads = (int)sysconf(_SC_NPROCESSORS_ONLN);
+
+    for (; Arg < argc && argv[Arg][0] == '-'; Arg++) {
+        if (!strcmp(argv[Arg], "-plain")) {
+            Plain = EMBERS_TRUE;
+        } else if (!strcmp(argv[Arg], "-hash") && Arg + 1 < argc) {
+            Megabytes = strtoul(argv[++Arg], NULL, 10);
+        } else if (!strcmp(argv[Arg], "-threads") && Arg + 1 < argc) {
+            Threads = atoi(argv[++Arg]);
+        } else {
+            fprintf(stderr,
+                    "usage: %s [-plain] [-hash MB] [-threads N] "
+                    "[DEPTH [FEN]]\n",
+                    argv[0]);
+            return EXIT_FAILURE;
+        }
+    }
+
+    AttacksInit();
+    if (!AttacksSelfCheck()) {
+        fprintf(stderr, "attack tables failed the self-check\n");
+        return EXIT_FAILURE;
+    }
+
+    if (!Plain && Megabytes) {
+        if (!PerftTableCreate(&Table, Megabytes)) {
+            fprintf(stderr, "can't allocate a %zuMB table\n", Megabytes);
+            return EXIT_FAILURE;
+        }
+
+        Hash = &Table;
+    }
+
+    if (Threads < 1)
+        Threads = 1;
+
+    if (!Plain)
+        printf("%d threads, %zuMB hash\n", Threads, Hash ? Megabytes : 0);
+
+    if (Arg == argc) {
+        Status = RunCases();
+    } else if ((Depth = atoi(argv[Arg])) < 1) {
+        fprintf(stderr, "bad depth: %s\n", argv[Arg]);
+        Status = EXIT_FAILURE;
+    } else {
+        Status = Divide(Arg + 1 < argc ? argv[Arg + 1] : PERFT_START_FEN,
+                        Depth);
+    }
+
+    if (Hash)
+        PerftTableFree(Hash);
+
+    return Status;
+}
@@ -8,12 +8,15 @@
 #define BOARD_WIDTH (8.f)
 #define BOARD_HEIGHT (8.f)
 
-#define FLAG_HIGHLIGHTED (0x1)
 #define FLAG_WHITE (0x2)
 #define FLAG_BLACK (0x4)
 
 #define GRID_COL1 vec3(118,150,86)
 #define GRID_COL2 vec3(238,238,210)
+#define CANDIDATE_COL vec3(235,140,52)
+
+/* Green above this is the highlight, below it down to 0 a candidate's rank.  */
+#define HIGHLIGHT_GREEN (0.9f)
 
 uniform sampler2D DataTexture;
 
@@ -58,15 +61,20 @@ void SetUVs(int Piece, int Team)
 void main(){
     int x = ID % int(BOARD_WIDTH),
         y = ID / int(BOARD_HEIGHT),
-        Diag =  x + y,
-        Tst = int(texture(DataTexture, vec2(x / BOARD_WIDTH, y / BOARD_HEIGHT)).r * 255);
+        Diag =  x + y;
+
+    /* Red holds the piece flags, green the highlight or a candidate's rank.  */
+    vec2 Data = texture(DataTexture, vec2(x / BOARD_WIDTH, y / BOARD_HEIGHT)).rg;
+    int Tst = int(Data.r * 255);
 
 
     vec3 WorldPosition = (vec4(Position, 0.f, 1.f) * World).xyz;
     fColour = Diag % 2 == 0 ? GRID_COL1 / 255.f : GRID_COL2 / 255.f;
 
-    if (CheckFlag(Tst, FLAG_HIGHLIGHTED))
+    if (Data.g > HIGHLIGHT_GREEN)
         fColour *= vec3(0.3, 0.1, 0.85);
+    else if (Data.g > 0.f)
+        fColour = mix(fColour, CANDIDATE_COL / 255.f, Data.g);
 
     if (CheckFlag(Tst, FLAG_WHITE)) {
         SetUVs(Tst >> 4, 1);